@@ -0,0 +1,46 @@
+/**
+* @file     dirs.c
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    C program for an interactive memory game between microcontrollers - packed directions
+*
+* Directions are kept as 2 bit codes, four to a byte with the first in
+* the low bits. The packed bytes are also what is sent over infra-red.
+*/
+
+#include "dirs.h"
+
+#define DIRECTION_MASK 0x03
+
+static const char directionChars[] = "NESW";
+
+/**
+ * Converts a direction char to its 2 bit code
+ */
+static uint8_t directionCode ( char direction ) {
+    uint8_t code = 0;
+
+    while ( ( code < DIRECTION_MASK ) && ( directionChars[ code ] != direction ) ) {
+        code++;
+    }
+    return code;
+}
+
+/**
+ * Sets the direction char at an index of a sequence of directions
+ */
+void directionsSet ( directions_t *directions, uint8_t index, char direction ) {
+    uint8_t shift = ( index % DIRECTIONS_PER_BYTE ) * DIRECTION_BITS;
+    uint8_t *byte = &directions->bits[ index / DIRECTIONS_PER_BYTE ];
+
+    *byte = ( *byte & ~( DIRECTION_MASK << shift ) ) | ( directionCode ( direction ) << shift );
+}
+
+/**
+ * Returns the direction char at an index of a sequence of directions
+ */
+char directionsGet ( const directions_t *directions, uint8_t index ) {
+    uint8_t shift = ( index % DIRECTIONS_PER_BYTE ) * DIRECTION_BITS;
+
+    return directionChars[ ( directions->bits[ index / DIRECTIONS_PER_BYTE ] >> shift ) & DIRECTION_MASK ];
+}
@@ -0,0 +1,52 @@
+/**
+* @file     dirs.h
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Header file for dirs.c of the interactive memory game between microcontrollers - packed directions
+*/
+
+#ifndef DIRS_H
+#define DIRS_H
+
+#include <stdint.h>
+
+#define MAXIMUM_DIRECTIONS 8 // the most directions a level has, up to 64; frames and counts are sized from it
+#define DIRECTIONS_CAPACITY MAXIMUM_DIRECTIONS // a sequence holds no more than the longest level needs
+#define DIRECTION_BITS 2
+#define DIRECTIONS_PER_BYTE ( 8 / DIRECTION_BITS )
+#define DIRECTIONS_BYTES(count) ( ( ( count ) + DIRECTIONS_PER_BYTE - 1 ) / DIRECTIONS_PER_BYTE )
+
+/**
+ * The levels, from LVL_ONE on, each a ROW ( directions, glyph ): the
+ * number of directions played, up to MAXIMUM_DIRECTIONS, and the char
+ * SENDER is shown while entering them. A level is added by adding its
+ * row alone: play.c's level table and react.h's reaction time cells are
+ * built from these, and the build checks each glyph is in the font.
+ */
+#define LEVEL_ROWS(ROW) \
+    ROW ( 4, '4' ) \
+    ROW ( 6, '6' ) \
+    ROW ( 8, '8' )
+#define LEVEL_COUNTED(directions, glyph) + 1
+#define LEVEL_COUNT ( 0 LEVEL_ROWS ( LEVEL_COUNTED ) )
+
+
+/**
+ * A sequence of N, S, E, or W directions packed at 2 bits each
+ */
+typedef struct {
+    uint8_t bits[ DIRECTIONS_BYTES ( DIRECTIONS_CAPACITY ) ];
+} directions_t;
+
+
+/**
+ * Sets the direction char at an index of a sequence of directions
+ */
+void directionsSet ( directions_t *directions, uint8_t index, char direction );
+
+
+/**
+ * Returns the direction char at an index of a sequence of directions
+ */
+char directionsGet ( const directions_t *directions, uint8_t index );
+#endif
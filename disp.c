@@ -3,33 +3,118 @@
 * @authors  Courtney Bracefield (and/or tutor(s)), and Adam Ross
 * @date     12 Oct 2016
 * @brief    C program for an interactive memory game between microcontrollers - displaying of chars
+*
+* The display functions only record what is to be shown. displayFrame ()
+* draws a whole frame into the matrix's back buffer when that has
+* changed, and swaps it in, so a char shown every tick is drawn once.
+* The matrix is refreshed from the front buffer by its own interrupt,
+* however long a game step takes.
+*
+* Scrolling strings are kept in flash and scrolled here rather than by
+* tinygl_text, which would need them in SRAM. When a string is first
+* shown it is rendered into a strip of display rows, and each scroll
+* step then only copies the rows under the display from the strip.
+*
+* Chars are drawn from glyphs3x5 and glyphs5x7, the subsets of font3x5_1
+* and font5x7_1 the build cuts down to the glyphs the game uses. Both are
+* pre-rendered as columns, so a static char is shown by copying its five
+* columns to the frame, and a scroll glyph column is a display row.
 */
 
-#include "tinygl.h"
-#include "../fonts/font3x5_1.h"
-#include "../fonts/font5x7_1.h"
-#include "play.h"
+#include "glyphs3x5.h"
+#include "glyphs5x7.h"
+#include "disp.h"
+#include "flash.h"
+#include <stdbool.h>
+#include <string.h>
 
 #define ONE 'A'
 #define TWO 'B'
 #define THREE 'C'
+#define SHOW_NOTHING 0
+#define SHOW_CHAR 1
+#define SHOW_STRING 2
+#define SCROLL_SPEED 20 // rows per second
+#define STATIC_FONT glyphs5x7
+#define SCROLL_FONT glyphs3x5
+#define SCROLL_GAP ( DISPLAY_HEIGHT - 1 ) // blank rows before a string repeats
 
 /**
- * Changes tinygl settings for displaying single chars
+ * Draws a single char filling a frame, copying each pre-rendered column
+ * of its glyph straight to the frame's column
  */
-void setStaticDisplay ( void ) {
-    tinygl_font_set ( &font5x7_1 );
-    tinygl_text_mode_set ( TINYGL_TEXT_MODE_STEP );
-    tinygl_text_dir_set ( TINYGL_TEXT_DIR_NORMAL );
+static void staticDraw ( uint8_t *frame, char ch ) {
+    int8_t glyph = glyphFind ( &STATIC_FONT, ch );
+    uint8_t x;
+
+    for ( x = 0; x < DISPLAY_WIDTH; x++ ) {
+        frame[ x ] = glyphColumn ( &STATIC_FONT, glyph, x );
+    }
+}
+
+/**
+ * Renders a flash string into the strip of display rows it scrolls
+ * through, each a pre-rendered glyph column, with a blank row after each
+ * char. The build checks no string is longer than SCROLL_CHARS_MAX.
+ */
+static void scrollRender ( disp_t *disp ) {
+    const char *str = disp->showString;
+    uint8_t length = 0, column;
+    int8_t glyph;
+
+    while ( FLASH_READ_BYTE ( str ) && ( length < SCROLL_STRIP_MAX ) ) {
+        glyph = glyphFind ( &SCROLL_FONT, FLASH_READ_BYTE ( str++ ) );
+
+        for ( column = 0; column < SCROLL_FONT.width; column++ ) {
+            disp->strip[ length++ ] = glyphColumn ( &SCROLL_FONT, glyph, column );
+        }
+        disp->strip[ length++ ] = 0;
+    }
+    disp->scrollLength = length;
+}
+
+/**
+ * Draws the rows of the strip from the scroll position on into a frame,
+ * each row a glyph column rotated to read down the display
+ */
+static void scrollDraw ( const disp_t *disp, uint8_t *frame ) {
+    uint8_t row = disp->scrollRow;
+    uint8_t x, y, pixels;
+
+    memset ( frame, 0, DISPLAY_WIDTH );
+
+    for ( y = 0; y < DISPLAY_HEIGHT; y++ ) {
+        pixels = row < disp->scrollLength ? disp->strip[ row ] : 0;
+
+        for ( x = 0; x < DISPLAY_WIDTH; x++ ) {
+            if ( pixels & ( 1 << x ) ) {
+                frame[ DISPLAY_WIDTH - 1 - x ] |= 1 << y;
+            }
+        }
+
+        if ( ++row == disp->scrollLength + SCROLL_GAP ) {
+            row = 0;
+        }
+    }
 }
 
 /**
- * Changes tinygl settings for displaying scrolling strings
+ * Moves a scrolling string on by a row every frameRate / SCROLL_SPEED
+ * frames in which the matrix is ready to be drawn. Returns true if it
+ * moved on.
  */
-void setScrollDisplay ( void ) {
-    tinygl_font_set ( &font3x5_1 );
-    tinygl_text_mode_set ( TINYGL_TEXT_MODE_SCROLL );
-    tinygl_text_dir_set ( TINYGL_TEXT_DIR_ROTATE );
+static bool scrollUpdate ( disp_t *disp ) {
+    if ( ++disp->scrollFrames < disp->frameRate / SCROLL_SPEED ) {
+        return false;
+    }
+    disp->scrollFrames = 0;
+
+    if ( ++disp->scrollRow == disp->scrollLength + SCROLL_GAP ) {
+        disp->scrollRow = 0;
+    }
+    scrollDraw ( disp, matrixBack ( &disp->matrix ) );
+    matrixSwap ( &disp->matrix );
+    return true;
 }
 
 /**
@@ -37,7 +122,7 @@ void setScrollDisplay ( void ) {
  * If char is 'A', 'B', 'C', converts to a corresponding
  * number between 1-3 for displaying the game difficulty.
  */
-void displayChar ( char *dispChar ) {
+void displayChar ( disp_t *disp, char *dispChar ) {
     char newChar;
 
     if ( *dispChar == ONE ) {
@@ -49,57 +134,136 @@ void displayChar ( char *dispChar ) {
     } else {
         newChar = *dispChar;
     }
-
-    tinygl_clear();
-    tinygl_draw_char ( newChar, tinygl_point ( 0, 0 ) );
-    tinygl_update ();
+    displayConst ( disp, newChar );
 }
 
 /**
  * Displays a constant to LED
  */
-void displayConst ( char constant ) {
-    tinygl_clear ();
-    tinygl_draw_char ( constant, tinygl_point ( 0, 0 ) );
-    tinygl_update ();
+void displayConst ( disp_t *disp, char constant ) {
+    disp->show = SHOW_CHAR;
+    disp->showChar = constant;
+}
+
+/**
+ * Displays a scrolling string of chars kept in flash
+ */
+void displayString ( disp_t *disp, const char str[] ) {
+    disp->show = SHOW_STRING;
+    disp->showString = str;
+}
+
+/**
+ * Displays a scrolling string of chars kept in flash that repeats
+ * continuously until something else is displayed
+ */
+void continuousScroll ( disp_t *disp, const char str[] ) {
+    displayString ( disp, str );
+}
+
+/**
+ * Blanks the LED
+ */
+void displayClear ( disp_t *disp ) {
+    disp->show = SHOW_NOTHING;
+}
+
+/**
+ * Returns true if what is to be displayed differs from what was last drawn
+ */
+static bool displayChanged ( const disp_t *disp ) {
+    if ( disp->show != disp->shown ) {
+        return true;
+    } else if ( disp->show == SHOW_CHAR ) {
+        return disp->showChar != disp->shownChar;
+    } else if ( disp->show == SHOW_STRING ) {
+        return disp->showString != disp->shownString;
+    }
+    return false;
+}
+
+/**
+ * Draws what is to be displayed into the back frame and swaps it in,
+ * starting a scrolling string from its first row
+ */
+static void displayRedraw ( disp_t *disp ) {
+    uint8_t *frame = matrixBack ( &disp->matrix );
+
+    if ( disp->show == SHOW_CHAR ) {
+        staticDraw ( frame, disp->showChar );
+    } else if ( disp->show == SHOW_STRING ) {
+        disp->scrollRow = 0;
+        disp->scrollFrames = 0;
+        scrollRender ( disp );
+        scrollDraw ( disp, frame );
+    } else {
+        memset ( frame, 0, DISPLAY_WIDTH );
+    }
+    matrixSwap ( &disp->matrix );
+    disp->shown = disp->show;
+    disp->shownChar = disp->showChar;
+    disp->shownString = disp->showString;
+}
+
+/**
+ * Redraws the LED if what is to be displayed has changed since the
+ * last frame, or moves a scrolling string on. Nothing is drawn until
+ * the matrix shows the last frame swapped in, so a change may wait a
+ * few frames. Called exactly once per frame, each frame counted as
+ * redrawn, scrolled or skipped.
+ */
+void displayFrame ( disp_t *disp ) {
+    if ( !matrixReady ( &disp->matrix ) ) {
+        disp->stats.skips++;
+    } else if ( displayChanged ( disp ) ) {
+        displayRedraw ( disp );
+        disp->stats.redraws++;
+    } else if ( ( disp->shown == SHOW_STRING ) && scrollUpdate ( disp ) ) {
+        disp->stats.scrolls++;
+    } else {
+        disp->stats.skips++;
+    }
+}
+
+/**
+ * Returns the flash string being scrolled, or 0 if none is
+ */
+const char *displayScrolling ( const disp_t *disp ) {
+    return disp->shown == SHOW_STRING ? disp->shownString : 0;
 }
 
 /**
- * Displays a scrolling string of chars
+ * Returns the char being shown, or 0 if none is
  */
-void displayString ( const char str[] ) {
-    tinygl_clear ();
-    tinygl_text ( str );
-    tinygl_update ();
+char displayShownChar ( const disp_t *disp ) {
+    return disp->shown == SHOW_CHAR ? disp->shownChar : 0;
 }
 
 /**
- * Converts tinygl settings for scrolling strings, displays a
- * scrolling string continuously until navswitch is pushed
- * then converts tinygl settings back to displaying chars
+ * Returns the counts of frames redrawn, scrolled and skipped since
+ * displayInit ()
  */
-void continuousScroll ( const char str[] ) {
-    setScrollDisplay ();
-    tinygl_clear ();
-    displayString ( str );
-    navPushUpdate ();
-    setStaticDisplay ();
+disp_stats_t displayStats ( const disp_t *disp ) {
+    return disp->stats;
 }
 
 /**
- * Displays a scroll of text
+ * Changes the number of frames a second. Scrolling moves on a row every
+ * frameRate / SCROLL_SPEED frames, so keeps its speed.
  */
-void singleScroll ( const char str[] ) {
-    setScrollDisplay ();
-    tinygl_clear ();
-    displayString ( str );
-    setStaticDisplay ();
+void displayRate ( disp_t *disp, int loopRate ) {
+    disp->frameRate = loopRate;
 }
 
 /**
- * Initialiser for tinygl and scrolling string setter for game start
+ * Initialiser for the LED matrix and scrolling string setter for game start
  */
-void displayInit ( int loopRate ) {
-    tinygl_init ( loopRate );
-    setScrollDisplay ();
+void displayInit ( disp_t *disp, int loopRate ) {
+    matrixInit ( &disp->matrix );
+    disp->show = SHOW_NOTHING;
+    disp->shown = SHOW_NOTHING;
+    disp->frameRate = loopRate;
+    disp->stats.redraws = 0;
+    disp->stats.scrolls = 0;
+    disp->stats.skips = 0;
 }
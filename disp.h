@@ -9,17 +9,40 @@
 #ifndef DISP_H
 #define DISP_H
 
+#include <stdint.h>
+#include "matrix.h"
+
+#define SCROLL_CHARS_MAX 16 // longest scrolling string, checked by the build
+#define SCROLL_STRIP_MAX ( SCROLL_CHARS_MAX * 4 ) // display rows of a string in the 3x5 font
+
 
 /**
- * Changes tinygl settings for displaying single chars
+ * Counts of frames since displayInit (): those redrawn for a change,
+ * those a scrolling string moved on in, and those skipped with nothing
+ * new to draw or while the matrix had yet to show the last frame
  */
-void setStaticDisplay ( void );
+typedef struct {
+    uint16_t redraws;
+    uint16_t scrolls;
+    uint16_t skips;
+} disp_stats_t;
 
 
 /**
- * Changes tinygl settings for displaying scrolling strings
+ * What one game is to display, what its LED matrix was last drawn with,
+ * the rendered rows of a scrolling string and how far it has moved, and
+ * the counts of frames drawn and skipped
  */
-void setScrollDisplay ( void );
+typedef struct {
+    uint8_t show, shown;
+    char showChar, shownChar;
+    const char *showString, *shownString;
+    matrix_t matrix;
+    uint8_t strip[ SCROLL_STRIP_MAX ];
+    uint8_t scrollRow, scrollLength, scrollFrames;
+    uint16_t frameRate;
+    disp_stats_t stats;
+} disp_t;
 
 
 /**
@@ -27,37 +50,68 @@ void setScrollDisplay ( void );
  * If char is 'A', 'B', 'C', converts to a corresponding
  * number between 1-3 for displaying the game difficulty.
  */
-void displayChar ( char *dispChar );
+void displayChar ( disp_t *disp, char *dispChar );
 
 
 /**
  * Displays a constant to LED
  */
-void displayConst ( char constant );
+void displayConst ( disp_t *disp, char constant );
+
+
+/**
+ * Displays a scrolling string of chars kept in flash
+ */
+void displayString ( disp_t *disp, const char str[] );
+
+
+/**
+ * Displays a scrolling string of chars kept in flash that repeats
+ * continuously until something else is displayed
+ */
+void continuousScroll ( disp_t *disp, const char str[] );
+
+
+/**
+ * Blanks the LED
+ */
+void displayClear ( disp_t *disp );
+
+
+/**
+ * Redraws the LED if what is to be displayed has changed since the
+ * last frame, or moves a scrolling string on. Called exactly once per frame.
+ */
+void displayFrame ( disp_t *disp );
+
+
+/**
+ * Returns the flash string being scrolled, or 0 if none is
+ */
+const char *displayScrolling ( const disp_t *disp );
 
 
 /**
- * Displays a scrolling string of chars
+ * Returns the char being shown, or 0 if none is
  */
-void displayString ( const char str[] );
+char displayShownChar ( const disp_t *disp );
 
 
 /**
- * Converts tinygl settings for scrolling strings, displays a
- * scrolling string continuously until navswitch is pushed
- * then converts tinygl settings back to displaying chars
+ * Returns the counts of frames redrawn, scrolled and skipped since
+ * displayInit ()
  */
-void continuousScroll ( const char str[] );
+disp_stats_t displayStats ( const disp_t *disp );
 
 
 /**
- * Displays a scroll of text
+ * Changes the number of frames a second, keeping the scroll speed
  */
-void singleScroll ( const char str[] );
+void displayRate ( disp_t *disp, int loopRate );
 
 
 /**
- * Initialiser for tinygl and scrolling string setter for game start
+ * Initialiser for the LED matrix and scrolling string setter for game start
  */
-void displayInit ( int loopRate );
+void displayInit ( disp_t *disp, int loopRate );
 #endif
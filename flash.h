@@ -0,0 +1,38 @@
+/**
+* @file     flash.h
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Header file of the interactive memory game between microcontrollers - constant tables kept in flash
+*/
+
+#ifndef FLASH_H
+#define FLASH_H
+
+#include <stdint.h>
+
+#ifdef __AVR__
+#include <avr/pgmspace.h>
+
+/**
+ * Reads a byte of a table kept in program memory
+ */
+#define FLASH_READ_BYTE(addr) pgm_read_byte ( addr )
+
+/**
+ * Reads a two byte word of a table kept in program memory
+ */
+#define FLASH_READ_WORD(addr) pgm_read_word ( addr )
+
+/**
+ * Copies a row of a table kept in program memory into SRAM
+ */
+#define FLASH_READ_BLOCK(dest, addr, size) memcpy_P ( ( dest ), ( addr ), ( size ) )
+#else
+#include <string.h>
+
+#define PROGMEM
+#define FLASH_READ_BYTE(addr) ( *( const uint8_t * ) ( addr ) )
+#define FLASH_READ_WORD(addr) ( *( const uint16_t * ) ( addr ) )
+#define FLASH_READ_BLOCK(dest, addr, size) memcpy ( ( dest ), ( addr ), ( size ) )
+#endif
+#endif
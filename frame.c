@@ -0,0 +1,257 @@
+/**
+* @file     frame.c
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    C program for an interactive memory game between microcontrollers - framed infra-red messages
+*/
+
+#include "ir.h"
+#include "flash.h"
+#include "frame.h"
+
+#if defined ( RECORD ) && defined ( __AVR__ )
+#include <util/atomic.h>
+#endif
+
+#define INDEX_TYPE 1
+#define INDEX_SEQUENCE 2
+#define INDEX_LENGTH 3
+
+static const uint8_t crcTable[ 256 ] PROGMEM = {
+    0x00, 0x07, 0x0e, 0x09, 0x1c, 0x1b, 0x12, 0x15, 0x38, 0x3f, 0x36, 0x31, 0x24, 0x23, 0x2a, 0x2d,
+    0x70, 0x77, 0x7e, 0x79, 0x6c, 0x6b, 0x62, 0x65, 0x48, 0x4f, 0x46, 0x41, 0x54, 0x53, 0x5a, 0x5d,
+    0xe0, 0xe7, 0xee, 0xe9, 0xfc, 0xfb, 0xf2, 0xf5, 0xd8, 0xdf, 0xd6, 0xd1, 0xc4, 0xc3, 0xca, 0xcd,
+    0x90, 0x97, 0x9e, 0x99, 0x8c, 0x8b, 0x82, 0x85, 0xa8, 0xaf, 0xa6, 0xa1, 0xb4, 0xb3, 0xba, 0xbd,
+    0xc7, 0xc0, 0xc9, 0xce, 0xdb, 0xdc, 0xd5, 0xd2, 0xff, 0xf8, 0xf1, 0xf6, 0xe3, 0xe4, 0xed, 0xea,
+    0xb7, 0xb0, 0xb9, 0xbe, 0xab, 0xac, 0xa5, 0xa2, 0x8f, 0x88, 0x81, 0x86, 0x93, 0x94, 0x9d, 0x9a,
+    0x27, 0x20, 0x29, 0x2e, 0x3b, 0x3c, 0x35, 0x32, 0x1f, 0x18, 0x11, 0x16, 0x03, 0x04, 0x0d, 0x0a,
+    0x57, 0x50, 0x59, 0x5e, 0x4b, 0x4c, 0x45, 0x42, 0x6f, 0x68, 0x61, 0x66, 0x73, 0x74, 0x7d, 0x7a,
+    0x89, 0x8e, 0x87, 0x80, 0x95, 0x92, 0x9b, 0x9c, 0xb1, 0xb6, 0xbf, 0xb8, 0xad, 0xaa, 0xa3, 0xa4,
+    0xf9, 0xfe, 0xf7, 0xf0, 0xe5, 0xe2, 0xeb, 0xec, 0xc1, 0xc6, 0xcf, 0xc8, 0xdd, 0xda, 0xd3, 0xd4,
+    0x69, 0x6e, 0x67, 0x60, 0x75, 0x72, 0x7b, 0x7c, 0x51, 0x56, 0x5f, 0x58, 0x4d, 0x4a, 0x43, 0x44,
+    0x19, 0x1e, 0x17, 0x10, 0x05, 0x02, 0x0b, 0x0c, 0x21, 0x26, 0x2f, 0x28, 0x3d, 0x3a, 0x33, 0x34,
+    0x4e, 0x49, 0x40, 0x47, 0x52, 0x55, 0x5c, 0x5b, 0x76, 0x71, 0x78, 0x7f, 0x6a, 0x6d, 0x64, 0x63,
+    0x3e, 0x39, 0x30, 0x37, 0x22, 0x25, 0x2c, 0x2b, 0x06, 0x01, 0x08, 0x0f, 0x1a, 0x1d, 0x14, 0x13,
+    0xae, 0xa9, 0xa0, 0xa7, 0xb2, 0xb5, 0xbc, 0xbb, 0x96, 0x91, 0x98, 0x9f, 0x8a, 0x8d, 0x84, 0x83,
+    0xde, 0xd9, 0xd0, 0xd7, 0xc2, 0xc5, 0xcc, 0xcb, 0xe6, 0xe1, 0xe8, 0xef, 0xfa, 0xfd, 0xf4, 0xf3
+};
+
+/**
+ * Adds a byte to a CRC-8 (polynomial 0x07) using a table kept in flash
+ */
+uint8_t crc8 ( uint8_t crc, uint8_t byte ) {
+    return FLASH_READ_BYTE ( &crcTable[ crc ^ byte ] );
+}
+
+/**
+ * Returns true if the transmission queue has room for a whole frame
+ * with a payload of a length
+ */
+bool frameRoom ( ir_t *ir, uint8_t length ) {
+    return ringFree ( &ir->tx ) >= FRAME_OVERHEAD + length;
+}
+
+/**
+ * Queues a frame's bytes for transmission
+ */
+static void frameQueue ( ir_t *ir, uint8_t type, uint8_t sequence, const uint8_t *payload, uint8_t length ) {
+    uint8_t crc = crc8 ( crc8 ( crc8 ( 0, type ), sequence ), length );
+    uint8_t i;
+
+    irPutc ( ir, FRAME_START );
+    irPutc ( ir, type );
+    irPutc ( ir, sequence );
+    irPutc ( ir, length );
+
+    for ( i = 0; i < length; i++ ) {
+        crc = crc8 ( crc, payload[ i ] );
+        irPutc ( ir, payload[ i ] );
+    }
+    irPutc ( ir, crc );
+}
+
+/**
+ * Transmits a frame as one burst of bytes. With RECORD on a board, it is
+ * queued with interrupts off, so no log frame starts between its bytes.
+ */
+void frameSend ( ir_t *ir, uint8_t type, uint8_t sequence, const uint8_t *payload, uint8_t length ) {
+#if defined ( RECORD ) && defined ( __AVR__ )
+    ATOMIC_BLOCK ( ATOMIC_RESTORESTATE ) {
+        frameQueue ( ir, type, sequence, payload, length );
+    }
+#else
+    frameQueue ( ir, type, sequence, payload, length );
+#endif
+}
+
+#ifdef RECORD
+_Static_assert ( FRAME_HEADER_SIZE + 2 * ( FRAME_RECORD_BYTES + 1 ) <= IR_LOG_BYTES, "a stuffed log frame overflows ir_t" );
+
+/**
+ * Queues a FRAME_RECORD frame of the board's log, its payload and CRC
+ * stuffed so it holds no FRAME_START but its first. Returns false, and
+ * queues nothing, while the last is still going out.
+ */
+bool frameSendLog ( ir_t *ir, uint8_t sequence, const uint8_t *payload, uint8_t length ) {
+    uint8_t bytes[ IR_LOG_BYTES ] = { FRAME_START, FRAME_RECORD, sequence, length };
+    uint8_t crc = crc8 ( crc8 ( crc8 ( 0, FRAME_RECORD ), sequence ), length );
+    uint8_t count = FRAME_HEADER_SIZE, byte, i;
+
+    if ( !irLogReady ( ir ) ) {
+        return false;
+    }
+
+    for ( i = 0; i <= length; i++ ) {
+        byte = i < length ? payload[ i ] : crc;
+        crc = crc8 ( crc, byte );
+
+        if ( ( byte == FRAME_START ) || ( byte == FRAME_ESCAPE ) ) {
+            bytes[ count++ ] = FRAME_ESCAPE;
+            byte ^= FRAME_ESCAPE_FLIP;
+        }
+        bytes[ count++ ] = byte;
+    }
+    return irPutLog ( ir, bytes, count );
+}
+#endif
+
+/**
+ * Discards any partially received frame
+ */
+void frameReset ( frame_parser_t *parser ) {
+    parser->index = 0;
+    parser->skipped = 0;
+}
+
+static bool frameAdd ( frame_parser_t *parser, uint8_t byte, bool resync );
+
+/**
+ * Abandons the frame being recepted on a byte that does not fit it, and
+ * tries the byte as the start of the next. A lost byte can make a
+ * FRAME_START in the payload of one frame look like the start of a
+ * frame, and the real start of the next look like part of it, which
+ * identical retransmissions would repeat forever. So unless already
+ * resyncing, the bytes after the false start are recepted again, once,
+ * from the first FRAME_START among them.
+ */
+static bool frameAbandon ( frame_parser_t *parser, uint8_t byte, bool resync ) {
+    const frame_t *frame = &parser->frame;
+    uint8_t bytes[ FRAME_HEADER_SIZE + FRAME_PAYLOAD_MAX ];
+    uint8_t count = 0, i;
+    bool received = false;
+
+    if ( resync ) {
+        if ( parser->index > INDEX_TYPE ) {
+            bytes[ count++ ] = frame->type;
+        }
+
+        if ( parser->index > INDEX_SEQUENCE ) {
+            bytes[ count++ ] = frame->sequence;
+        }
+
+        for ( i = INDEX_LENGTH; i < parser->index; i++ ) {
+            bytes[ count++ ] = i == INDEX_LENGTH ? frame->length : frame->payload[ i - FRAME_HEADER_SIZE ];
+        }
+    }
+    bytes[ count++ ] = byte;
+    parser->index = 0;
+
+    for ( i = 0; i < count; i++ ) {
+        received = frameAdd ( parser, bytes[ i ], false );
+    }
+    return received;
+}
+
+/**
+ * Passes over a byte of a log frame. Its payload and CRC are stuffed, so
+ * a FRAME_START can only be the start of the next frame, cutting it
+ * short. Its bytes are counted as skipped once it ends either way.
+ */
+static bool frameSkip ( frame_parser_t *parser, uint8_t byte ) {
+    if ( byte == FRAME_START ) {
+        parser->skipped += parser->index;
+        parser->index = 1;
+        parser->crc = 0;
+        return false;
+    }
+
+    if ( parser->index == INDEX_LENGTH ) {
+        parser->left = ( byte < FRAME_RECORD_BYTES ? byte : FRAME_RECORD_BYTES ) + 1;
+    } else if ( ( parser->index > INDEX_LENGTH ) && ( byte != FRAME_ESCAPE ) ) {
+        parser->left--;
+    }
+    parser->index++;
+
+    if ( ( parser->index > FRAME_HEADER_SIZE ) && !parser->left ) {
+        parser->skipped += parser->index;
+        parser->index = 0;
+    }
+    return false;
+}
+
+/**
+ * Adds a recepted byte to a frame, resyncing on a byte that does not
+ * fit it unless already resyncing
+ */
+static bool frameAdd ( frame_parser_t *parser, uint8_t byte, bool resync ) {
+    frame_t *frame = &parser->frame;
+
+    if ( parser->index == 0 ) {
+        parser->crc = 0;
+        parser->index = byte == FRAME_START;
+        return false;
+    }
+
+    if ( ( parser->index > INDEX_TYPE ) && ( frame->type == FRAME_RECORD ) ) {
+        return frameSkip ( parser, byte );
+    }
+
+    // Only a log frame cut short after its start leaves a FRAME_START alone
+    if ( ( parser->index == INDEX_TYPE ) && ( byte == FRAME_START ) ) {
+        parser->skipped++;
+        return false;
+    }
+
+    if ( parser->index == INDEX_TYPE ) {
+        frame->type = byte;
+    } else if ( parser->index == INDEX_SEQUENCE ) {
+        frame->sequence = byte;
+    } else if ( parser->index == INDEX_LENGTH ) {
+        if ( byte > FRAME_PAYLOAD_MAX ) {
+            return frameAbandon ( parser, byte, resync );
+        }
+        frame->length = byte;
+    } else if ( parser->index < FRAME_HEADER_SIZE + frame->length ) {
+        frame->payload[ parser->index - FRAME_HEADER_SIZE ] = byte;
+    } else if ( byte == parser->crc ) {
+        parser->index = 0;
+        return true;
+    } else {
+        return frameAbandon ( parser, byte, resync );
+    }
+    parser->crc = crc8 ( parser->crc, byte );
+    parser->index++;
+    return false;
+}
+
+/**
+ * Adds a recepted byte to a frame. Returns true once a whole frame with
+ * a correct CRC has been recepted, which is then held in parser->frame
+ * until the next byte is added. Bytes outside of a frame are discarded,
+ * as is any frame too long or failing its CRC, though the bytes of a bad
+ * frame are searched for the start of the next.
+ */
+bool frameReceive ( frame_parser_t *parser, uint8_t byte ) {
+    return frameAdd ( parser, byte, true );
+}
+
+/**
+ * Returns the bytes of log frames passed over since last called, those
+ * of a log frame counted once it ends, whole or cut short
+ */
+uint8_t frameSkipped ( frame_parser_t *parser ) {
+    uint8_t skipped = parser->skipped;
+
+    parser->skipped = 0;
+    return skipped;
+}
@@ -0,0 +1,104 @@
+/**
+* @file     frame.h
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Header file for frame.c of the interactive memory game between microcontrollers - framed infra-red messages
+*/
+
+#ifndef FRAME_H
+#define FRAME_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "dirs.h"
+#include "ir.h"
+
+#define FRAME_START 0xA5
+#define FRAME_HEADER_SIZE 4
+#define FRAME_OVERHEAD ( FRAME_HEADER_SIZE + 1 )
+#define FRAME_DIRECTIONS_PAYLOAD ( 1 + DIRECTIONS_BYTES ( DIRECTIONS_CAPACITY ) ) // the count, then the packed directions
+#define FRAME_REPORT_PAYLOAD 9 // a report of reaction times, as react.h builds it
+#define FRAME_PAYLOAD_MAX ( FRAME_DIRECTIONS_PAYLOAD > FRAME_REPORT_PAYLOAD ? FRAME_DIRECTIONS_PAYLOAD : FRAME_REPORT_PAYLOAD )
+#define FRAME_DIRECTIONS 'D'
+#define FRAME_ACK 'K'
+#define FRAME_RECORD 'L' // a board's streamed log, passed over by every parser
+#define FRAME_RECORD_BYTES 16 // the longest payload of a log frame
+#define FRAME_ESCAPE 0x5A // in a log frame, comes before a byte of payload or CRC that is FRAME_START or itself, flipped
+#define FRAME_ESCAPE_FLIP 0x20
+
+
+/**
+ * A message sent over infra-red as one burst of bytes:
+ * start, type, sequence id, length, payload, CRC-8 of type to payload
+ */
+typedef struct {
+    uint8_t type;
+    uint8_t sequence;
+    uint8_t length;
+    uint8_t payload[ FRAME_PAYLOAD_MAX ];
+} frame_t;
+
+
+/**
+ * Reception of a frame one byte at a time, with the bytes of log frames
+ * passed over since last taken, and the payload and CRC bytes left of
+ * the log frame being passed over
+ */
+typedef struct {
+    uint8_t index;
+    uint8_t crc;
+    uint8_t skipped, left;
+    frame_t frame;
+} frame_parser_t;
+
+
+/**
+ * Adds a byte to a CRC-8 (polynomial 0x07) using a table kept in flash
+ */
+uint8_t crc8 ( uint8_t crc, uint8_t byte );
+
+
+/**
+ * Returns true if the transmission queue has room for a whole frame
+ * with a payload of a length
+ */
+bool frameRoom ( ir_t *ir, uint8_t length );
+
+
+/**
+ * Transmits a frame as one burst of bytes
+ */
+void frameSend ( ir_t *ir, uint8_t type, uint8_t sequence, const uint8_t *payload, uint8_t length );
+
+
+#ifdef RECORD
+/**
+ * Queues a FRAME_RECORD frame of the board's log, its payload and CRC
+ * stuffed so it holds no FRAME_START but its first. Returns false, and
+ * queues nothing, while the last is still going out.
+ */
+bool frameSendLog ( ir_t *ir, uint8_t sequence, const uint8_t *payload, uint8_t length );
+#endif
+
+
+/**
+ * Discards any partially received frame
+ */
+void frameReset ( frame_parser_t *parser );
+
+
+/**
+ * Adds a recepted byte to a frame. Returns true once a whole frame with
+ * a correct CRC has been recepted, which is then held in parser->frame
+ * until the next byte is added. The bytes of a bad frame are searched
+ * for the start of the next. Log frames are passed over, never returned.
+ */
+bool frameReceive ( frame_parser_t *parser, uint8_t byte );
+
+
+/**
+ * Returns the bytes of log frames passed over since last called, those
+ * of a log frame counted once it ends, whole or cut short
+ */
+uint8_t frameSkipped ( frame_parser_t *parser );
+#endif
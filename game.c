@@ -7,61 +7,104 @@
 
 #include "system.h"
 #include "led.h"
-#include "ir_uart.h"
-#include "pacer.h"
-#include "navswitch.h"
-#include "tinygl.h"
-#include "disp.h"
-#include "play.h"
-#include <stdbool.h>
+#include "game.h"
+#include "prof.h"
+#include "trace.h"
+#include "record.h"
 
-#define PACER_RATE 300
-#define SENDER '$'
-#define RECEIVER 'R'
-#define NO_PLAY 'V'
+#if defined ( PROFILE ) || defined ( TRACE ) || defined ( LINKSTATS ) || defined ( RECORD )
+#include "button.h"
+#endif
 
-int main ( void ) {
+/**
+ * Initialiser for the board drivers and a game
+ */
+void gameInit ( game_t *game ) {
     system_init ();
-    ir_uart_init ();
-    navswitch_init ();
-    pacer_init ( PACER_RATE );
-    displayInit ( PACER_RATE );
+    irInit ( &game->ir );
+    paceInit ( &game->pace, PACER_RATE );
+    inputInit ( &game->input );
+    tickInit ( &game->tick, PACER_RATE );
+    traceInit ( &game->trace, &game->tick );
+    traceSelect ( &game->trace );
+    recordInit ( &game->record, &game->pace );
+    recordSelect ( &game->record );
+    displayInit ( &game->disp, PACER_RATE );
     led_init ();
+    profInit ();
+#if defined ( PROFILE ) || defined ( TRACE ) || defined ( LINKSTATS ) || defined ( RECORD )
+    button_init ();
+#endif
+    playInit ( game );
+#ifdef TOURNAMENT_NODES
+    playTournament ( game, TOURNAMENT_NODE, TOURNAMENT_NODES );
+#endif
+#if defined ( RECORD ) && defined ( __AVR__ )
+    recordStream ( &game->record, &game->ir, game->node, game->nodes );
+#endif
+}
 
-    ///Boolean initialisers for whether the game is won and for confirmed receptions of infra-red transmitted data
-    bool gameWon = false, parametersTransmitted = false;
-
-    ///Char initialiser for game-play turn
-    char play = NO_PLAY;
+/**
+ * Runs the game loop at PACER_IDLE_RATE while the game only scrolls,
+ * awaiting a push, and at PACER_RATE otherwise, keeping the tick clock
+ * and the display to the rate
+ */
+static void gameRate ( game_t *game ) {
+    uint16_t rate = playIdle ( game ) ? PACER_IDLE_RATE : PACER_RATE;
 
-    while ( 1 ) {
-        pacer_wait ();
-        tinygl_update ();
-        navswitch_update ();
+    if ( rate != game->pace.rate ) {
+        paceRate ( &game->pace, rate );
+        tickRate ( &game->tick, rate );
+        displayRate ( &game->disp, rate );
+    }
+}
 
-        while ( !gameWon ) {
-            pacer_wait ();
-            tinygl_update ();
+/**
+ * Runs one pacer tick of the game loop. The pass is timed against the
+ * period it was paced at, before gameRate () changes it.
+ */
+void gameTick ( game_t *game ) {
+    PROF_BEGIN ( start );
 
-            if ( play == RECEIVER ) {
-                if ( !parametersTransmitted ) {
-                    setGameParameters ( &parametersTransmitted );
-                }
+    traceSelect ( &game->trace );
+    recordSelect ( &game->record );
+    recordPass ( &game->ir );
+    tickUpdate ( &game->tick );
+    playTick ( game );
+    displayFrame ( &game->disp );
+#if defined ( PROFILE ) || defined ( TRACE ) || defined ( LINKSTATS ) || defined ( RECORD )
+    button_update ();
 
-                if ( parametersTransmitted ) {
-                    playerTurnReceiver ( &gameWon, &parametersTransmitted, &play );
-                }
-            }
+    if ( button_push_event_p ( BUTTON1 ) ) {
+        profDump ();
+        traceDump ();
+#ifdef PROFILE
+        paceDump ( &game->pace );
+#endif
+#ifdef LINKSTATS
+        linkDump ( &game->link );
+#endif
+#ifdef RECORD
+        recordEnd ( playDigest ( game ) );
+#endif
+    }
+#endif
+    profDumpUpdate ( &game->ir );
+    traceDumpUpdate ( &game->ir );
+    linkDumpUpdate ( &game->link );
+    paceDumpUpdate ( &game->pace, &game->ir );
+    recordStreamUpdate ( &game->record );
+    PROF_LOOP_END ( start, game->pace.period );
+    gameRate ( game );
+}
 
-            if ( play == SENDER ) {
-                playerTurnSender ( &parametersTransmitted, &play );
-            }
+int main ( void ) {
+    static game_t game;
 
-            if ( play == NO_PLAY ) {
-                gameStart ( &play, PACER_RATE );
-            }
-        }
+    gameInit ( &game );
 
-        gameWin ( &gameWon, &play );
+    while ( 1 ) {
+        paceWait ( &game.pace );
+        gameTick ( &game );
     }
 }
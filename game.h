@@ -0,0 +1,27 @@
+/**
+* @file     game.h
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Header file for game.c of the interactive memory game between microcontrollers - main
+*/
+
+#ifndef GAME_H
+#define GAME_H
+
+#include "play.h"
+
+#define PACER_RATE 300
+#define PACER_IDLE_RATE 100 // while only scrolling, awaiting a push; a multiple of SCROLL_SPEED
+
+
+/**
+ * Initialiser for the board drivers and a game
+ */
+void gameInit ( game_t *game );
+
+
+/**
+ * Runs one pacer tick of the game loop
+ */
+void gameTick ( game_t *game );
+#endif
@@ -0,0 +1,33 @@
+/**
+* @file     glyph.c
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    C program for an interactive memory game between microcontrollers - subset fonts in flash
+*/
+
+#include "flash.h"
+#include "glyph.h"
+
+/**
+ * Returns the index of the glyph drawing a char, or GLYPH_NONE
+ */
+int8_t glyphFind ( const glyph_font_t *font, char ch ) {
+    uint8_t glyph;
+
+    for ( glyph = 0; glyph < font->count; glyph++ ) {
+        if ( FLASH_READ_BYTE ( font->chars + glyph ) == ( uint8_t ) ch ) {
+            return glyph;
+        }
+    }
+    return GLYPH_NONE;
+}
+
+/**
+ * Returns a column of a pre-rendered glyph, row 0 the low bit
+ */
+uint8_t glyphColumn ( const glyph_font_t *font, int8_t glyph, uint8_t col ) {
+    if ( glyph == GLYPH_NONE ) {
+        return 0;
+    }
+    return FLASH_READ_BYTE ( font->data + glyph * font->bytes + col );
+}
@@ -0,0 +1,44 @@
+/**
+* @file     glyph.h
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Header file for glyph.c of the interactive memory game between microcontrollers - subset fonts in flash
+*/
+
+#ifndef GLYPH_H
+#define GLYPH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define GLYPH_NONE -1
+
+
+/**
+ * A font cut down by tools/fontsub to the glyphs the game draws. The
+ * chars they draw, and their bytes, are in flash. The bytes are in
+ * font.c's layout, or if columns is set are pre-rendered a byte per
+ * column.
+ */
+typedef struct {
+    uint8_t width;
+    uint8_t height;
+    uint8_t bytes;
+    uint8_t count;
+    bool columns;
+    const char *chars;
+    const uint8_t *data;
+} glyph_font_t;
+
+
+/**
+ * Returns the index of the glyph drawing a char, or GLYPH_NONE
+ */
+int8_t glyphFind ( const glyph_font_t *font, char ch );
+
+
+/**
+ * Returns a column of a pre-rendered glyph, row 0 the low bit
+ */
+uint8_t glyphColumn ( const glyph_font_t *font, int8_t glyph, uint8_t col );
+#endif
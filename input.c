@@ -0,0 +1,197 @@
+/**
+* @file     input.c
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    C program for an interactive memory game between microcontrollers - queued navswitch input
+*
+* A switch's debounced state only changes once its reading has held the
+* new state for INPUT_DEBOUNCE samples in a row. A reading that goes
+* back before then is a bounce, and is counted as coalesced into the
+* press or release it belongs to. The queue is ring.c's lock-free scheme
+* with an event in each slot.
+*/
+
+#include "navswitch.h"
+#include "input.h"
+#include "record.h"
+
+#define INPUT_MASK ( INPUT_QUEUE_SIZE - 1 )
+
+#ifdef __AVR__
+#include "timer.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+
+#define SAMPLE_PERIOD ( TIMER_RATE / INPUT_SAMPLE_RATE ) // timer ticks, rounded down
+#define SAMPLE_REMAINDER ( TIMER_RATE % INPUT_SAMPLE_RATE )
+
+///The queue the sampling interrupt fills, that of the board's one game
+static input_t *pad;
+
+///Timer ticks the samples have fallen behind by, in 1/INPUT_SAMPLE_RATE ticks
+static uint16_t sampleLag;
+
+/**
+ * Samples the navswitch. As for the matrix scan, compare B is moved on
+ * a period at a time as timer 1 runs free for the pacer. TIMER_RATE is
+ * not a multiple of INPUT_SAMPLE_RATE: at 7812 ticks a second a period
+ * of 7 ticks alone would sample 1116 times a second, and the sample
+ * clock would gain 12%. So a period is a tick longer whenever the
+ * remainders lost to rounding down add up to a tick, and samples keep
+ * to INPUT_SAMPLE_RATE a second on average, each within a tick of its
+ * time. The clock is then as true as TIMER_RATE, itself rounded down
+ * from 7812.5.
+ */
+ISR ( TIMER1_COMPB_vect ) {
+    uint8_t period = SAMPLE_PERIOD;
+
+    sampleLag += SAMPLE_REMAINDER;
+
+    if ( sampleLag >= INPUT_SAMPLE_RATE ) {
+        sampleLag -= INPUT_SAMPLE_RATE;
+        period++;
+    }
+    OCR1B += period;
+    inputSample ( pad );
+}
+#endif
+
+/**
+ * Initialiser for the navswitch and an empty queue. On AVR this starts
+ * the sampling interrupt, so is called after the pacer's timer is set up.
+ */
+void inputInit ( input_t *input ) {
+    uint8_t navswitch;
+
+    navswitch_init ();
+    input->head = 0;
+    input->tail = 0;
+    input->down = 0;
+    input->millis = 0;
+    input->coalesced = 0;
+    input->dropped = 0;
+
+    for ( navswitch = 0; navswitch < NAVSWITCH_NUM; navswitch++ ) {
+        input->settle[ navswitch ] = 0;
+    }
+#ifdef __AVR__
+    pad = input;
+
+    ATOMIC_BLOCK ( ATOMIC_RESTORESTATE ) {
+        OCR1B = TCNT1 + SAMPLE_PERIOD;
+    }
+    TIFR1 = _BV ( OCF1B );
+    TIMSK1 |= _BV ( OCIE1B );
+    sei ();
+#endif
+}
+
+/**
+ * Producer side. Queues a press made at a time, or counts it as dropped if the queue is full.
+ */
+static void inputPut ( input_t *input, uint8_t navswitch, uint16_t time ) {
+    uint8_t head = input->head;
+
+    if ( ( uint8_t ) ( head - __atomic_load_n ( &input->tail, __ATOMIC_ACQUIRE ) ) == INPUT_QUEUE_SIZE ) {
+        input->dropped++;
+        return;
+    }
+    input->events[ head & INPUT_MASK ].navswitch = navswitch;
+    input->events[ head & INPUT_MASK ].time = time;
+    __atomic_store_n ( &input->head, ( uint8_t ) ( head + 1 ), __ATOMIC_RELEASE );
+}
+
+/**
+ * Samples the navswitch, queueing a press once a switch has been down
+ * for INPUT_DEBOUNCE samples. Called from the timer interrupt, or by a
+ * host build INPUT_SAMPLE_RATE times per simulated second.
+ */
+void inputSample ( input_t *input ) {
+    uint8_t navswitch, bit;
+
+    navswitch_update ();
+    input->millis++;
+
+    for ( navswitch = 0; navswitch < NAVSWITCH_NUM; navswitch++ ) {
+        bit = 1 << navswitch;
+
+        if ( !navswitch_down_p ( navswitch ) == !( input->down & bit ) ) {
+            if ( input->settle[ navswitch ] ) {
+                input->coalesced++;
+            }
+            input->settle[ navswitch ] = 0;
+        } else if ( ++input->settle[ navswitch ] == INPUT_DEBOUNCE ) {
+            input->settle[ navswitch ] = 0;
+            input->down ^= bit;
+
+            if ( input->down & bit ) {
+                inputPut ( input, navswitch, input->millis );
+            }
+        }
+    }
+}
+
+/**
+ * Consumer side. Takes the oldest queued press, returning false if there is none.
+ */
+bool inputGet ( input_t *input, input_event_t *event ) {
+    uint8_t tail = input->tail;
+
+    if ( __atomic_load_n ( &input->head, __ATOMIC_ACQUIRE ) == tail ) {
+        return false;
+    }
+    *event = input->events[ tail & INPUT_MASK ];
+    __atomic_store_n ( &input->tail, ( uint8_t ) ( tail + 1 ), __ATOMIC_RELEASE );
+    RECORD_NAV ( event );
+    return true;
+}
+
+/**
+ * Producer side. Queues a recorded press with the time it was made, in
+ * place of the sampling interrupt, as a host replay does.
+ */
+void inputReplay ( input_t *input, const input_event_t *event ) {
+    inputPut ( input, event->navswitch, event->time );
+}
+
+/**
+ * Reads a 16 bit value the sampling interrupt writes, without it
+ * changing between reading its two bytes
+ */
+static uint16_t inputRead ( const volatile uint16_t *value ) {
+    uint16_t read;
+
+#ifdef __AVR__
+    ATOMIC_BLOCK ( ATOMIC_RESTORESTATE ) {
+        read = *value;
+    }
+#else
+    read = *value;
+#endif
+    return read;
+}
+
+/**
+ * Returns the sample clock, in milliseconds modulo 65536
+ */
+uint16_t inputMillis ( input_t *input ) {
+    uint16_t millis = inputRead ( &input->millis );
+
+    RECORD_WORD ( RECORD_MILLIS, millis );
+    return millis;
+}
+
+/**
+ * Returns the number of switch bounces absorbed by the debouncing
+ */
+uint16_t inputCoalesced ( input_t *input ) {
+    return inputRead ( &input->coalesced );
+}
+
+/**
+ * Returns the number of presses dropped from a full queue
+ */
+uint16_t inputDropped ( input_t *input ) {
+    return inputRead ( &input->dropped );
+}
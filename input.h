@@ -0,0 +1,95 @@
+/**
+* @file     input.h
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Header file for input.c of the interactive memory game between microcontrollers - queued navswitch input
+*
+* The navswitch is sampled by a timer interrupt, INPUT_SAMPLE_RATE times
+* a second whatever the game loop is doing, and debounced. Each press is
+* queued with the time it was made, for the game to take at its own pace.
+*/
+
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "navswitch.h"
+
+#define INPUT_SAMPLE_RATE 1000 // samples per second, so the sample clock counts milliseconds
+#define INPUT_DEBOUNCE 5 // samples a switch must hold a new state for
+#define INPUT_QUEUE_SIZE 8 // power of two
+#define INPUT_NONE NAVSWITCH_NUM
+
+
+/**
+ * A navswitch press, and the sample clock's millisecond it was made in
+ */
+typedef struct {
+    uint8_t navswitch;
+    uint16_t time;
+} input_event_t;
+
+
+/**
+ * Navswitch presses waiting for the game, the debounced switch states
+ * and the samples each switch has differed from its state for. Only the
+ * sampling interrupt writes head and the counters, only the game tail.
+ */
+typedef struct {
+    uint8_t head;
+    uint8_t tail;
+    input_event_t events[ INPUT_QUEUE_SIZE ];
+    uint8_t down;
+    uint8_t settle[ NAVSWITCH_NUM ];
+    uint16_t millis;
+    uint16_t coalesced;
+    uint16_t dropped;
+} input_t;
+
+
+/**
+ * Initialiser for the navswitch and an empty queue. On AVR this starts
+ * the sampling interrupt, so is called after the pacer's timer is set up.
+ */
+void inputInit ( input_t *input );
+
+
+/**
+ * Samples the navswitch, queueing a press once a switch has been down
+ * for INPUT_DEBOUNCE samples. Called from the timer interrupt, or by a
+ * host build INPUT_SAMPLE_RATE times per simulated second.
+ */
+void inputSample ( input_t *input );
+
+
+/**
+ * Takes the oldest queued press, returning false if there is none
+ */
+bool inputGet ( input_t *input, input_event_t *event );
+
+
+/**
+ * Queues a recorded press with the time it was made, in place of the
+ * sampling interrupt, as a host replay does
+ */
+void inputReplay ( input_t *input, const input_event_t *event );
+
+
+/**
+ * Returns the sample clock, in milliseconds modulo 65536
+ */
+uint16_t inputMillis ( input_t *input );
+
+
+/**
+ * Returns the number of switch bounces absorbed by the debouncing
+ */
+uint16_t inputCoalesced ( input_t *input );
+
+
+/**
+ * Returns the number of presses dropped from a full queue
+ */
+uint16_t inputDropped ( input_t *input );
+#endif
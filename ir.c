@@ -0,0 +1,216 @@
+/**
+* @file     ir.c
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    C program for an interactive memory game between microcontrollers - buffered infra-red
+*
+* Recepted bytes are moved from the USART1 data register into a ring
+* buffer by the receive interrupt, so bytes arriving while the game is
+* busy are kept rather than overwritten by the next byte. Transmitted
+* bytes are queued in a second ring buffer and fed to the USART by its
+* data register empty interrupt, so the game never waits on the wire.
+* A RECORD build holds one frame of its log apart from the game's queue,
+* fed out only while that queue is empty. A game byte queued meanwhile
+* cuts the frame short, so it waits on at most the log byte already in
+* the USART, and the frame is sent again whole once the queue empties.
+* The log takes no room from the game's bytes, and its frames are
+* stuffed so a cut one never hides the start of the game's next.
+*/
+
+#include "ir_uart.h"
+#include "ring.h"
+#include "ir.h"
+#include "trace.h"
+#include "record.h"
+
+#ifdef __AVR__
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+
+///The queues the USART1 interrupts use, those of the board's one game
+static ir_t *port;
+#endif
+
+#ifdef RECORD
+#include <string.h>
+#endif
+
+/**
+ * Initialiser for the infra-red UART with interrupt driven reception
+ */
+void irInit ( ir_t *ir ) {
+    ir_uart_init ();
+    ringInit ( &ir->rx );
+    ringInit ( &ir->tx );
+#ifdef RECORD
+    ir->logLength = 0;
+    ir->logSent = 0;
+#endif
+    ir->dataOverruns = 0;
+#ifdef __AVR__
+    port = ir;
+    UCSR1B |= _BV ( RXCIE1 );
+    sei ();
+#endif
+}
+
+/**
+ * Adds a byte recepted by the infra-red UART to the reception buffer.
+ * Called from the USART1 receive interrupt, or by a host build.
+ */
+void irReceiveByte ( ir_t *ir, uint8_t byte ) {
+    ringPut ( &ir->rx, byte );
+}
+
+#ifdef __AVR__
+/**
+ * USART1 receive interrupt. A data overrun flag means a byte was lost
+ * in the USART itself before this interrupt could run.
+ */
+ISR ( USART1_RX_vect ) {
+    if ( UCSR1A & _BV ( DOR1 ) ) {
+        port->dataOverruns++;
+    }
+    irReceiveByte ( port, UDR1 );
+}
+#endif
+
+/**
+ * Returns true if a recepted byte is waiting to be read
+ */
+bool irReadReady ( ir_t *ir ) {
+    return ringCount ( &ir->rx ) > 0;
+}
+
+/**
+ * Reads the oldest recepted byte, or 0 if none is waiting
+ */
+char irGetc ( ir_t *ir ) {
+    uint8_t byte = 0;
+
+    if ( ringGet ( &ir->rx, &byte ) ) {
+        TRACE_EVENT ( TRACE_IR_RX, byte );
+        RECORD_BYTE ( RECORD_IR_RX, byte );
+    }
+    return byte;
+}
+
+/**
+ * Queues a byte for infra-red transmission without waiting on the wire.
+ * Returns false, and counts the byte as dropped, if the queue is full.
+ */
+bool irPutc ( ir_t *ir, char byte ) {
+    TRACE_EVENT ( TRACE_IR_TX, byte );
+
+    if ( !ringPut ( &ir->tx, byte ) ) {
+        return false;
+    }
+#ifdef __AVR__
+    UCSR1B |= _BV ( UDRIE1 );
+#endif
+    return true;
+}
+
+#ifdef RECORD
+/**
+ * Returns true once the last frame of the board's log is off the wire
+ */
+bool irLogReady ( ir_t *ir ) {
+    return !__atomic_load_n ( &ir->logLength, __ATOMIC_ACQUIRE );
+}
+
+/**
+ * Holds a frame of the board's log to go out whenever the transmission
+ * queue is empty. Returns false, and holds nothing, if the last frame
+ * is not yet off the wire or this one is too long.
+ */
+bool irPutLog ( ir_t *ir, const uint8_t *bytes, uint8_t length ) {
+    if ( !irLogReady ( ir ) || ( length > IR_LOG_BYTES ) ) {
+        return false;
+    }
+    memcpy ( ir->log, bytes, length );
+    ir->logSent = 0;
+    __atomic_store_n ( &ir->logLength, length, __ATOMIC_RELEASE );
+#ifdef __AVR__
+    UCSR1B |= _BV ( UDRIE1 );
+#endif
+    return true;
+}
+#endif
+
+/**
+ * Returns true if the transmission queue has no room for another byte
+ */
+bool irWriteFull ( ir_t *ir ) {
+    return ringCount ( &ir->tx ) == RING_SIZE;
+}
+
+/**
+ * Takes the next queued byte for the wire, returning false if none. A
+ * frame of the log goes out only while the transmission queue is empty,
+ * and a queued byte cuts it short, to be sent again whole. Called from
+ * the USART1 data register empty interrupt, or by a host build.
+ */
+bool irTransmitByte ( ir_t *ir, uint8_t *byte ) {
+#ifdef RECORD
+    uint8_t length = __atomic_load_n ( &ir->logLength, __ATOMIC_ACQUIRE );
+
+    if ( ringGet ( &ir->tx, byte ) ) {
+        ir->logSent = 0;
+        return true;
+    }
+
+    if ( ir->logSent >= length ) {
+        return false;
+    }
+    *byte = ir->log[ ir->logSent++ ];
+
+    if ( ir->logSent == length ) {
+        __atomic_store_n ( &ir->logLength, 0, __ATOMIC_RELEASE );
+    }
+    return true;
+#else
+    return ringGet ( &ir->tx, byte );
+#endif
+}
+
+#ifdef __AVR__
+/**
+ * USART1 data register empty interrupt. Feeds the next queued byte to
+ * the USART, or disables itself once the queue has emptied.
+ */
+ISR ( USART1_UDRE_vect ) {
+    uint8_t byte;
+
+    if ( irTransmitByte ( port, &byte ) ) {
+        UDR1 = byte;
+    } else {
+        UCSR1B &= ~_BV ( UDRIE1 );
+    }
+}
+#endif
+
+/**
+ * Returns the number of recepted bytes lost, either to a full
+ * reception buffer or to a USART data overrun
+ */
+uint16_t irOverruns ( ir_t *ir ) {
+    uint16_t overruns;
+
+#ifdef __AVR__
+    ATOMIC_BLOCK ( ATOMIC_RESTORESTATE ) {
+        overruns = ir->rx.overruns + ir->dataOverruns;
+    }
+#else
+    overruns = ir->rx.overruns + ir->dataOverruns;
+#endif
+    return overruns;
+}
+
+/**
+ * Returns the number of bytes dropped from a full transmission queue
+ */
+uint16_t irTxDropped ( ir_t *ir ) {
+    return ir->tx.overruns;
+}
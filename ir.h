@@ -0,0 +1,110 @@
+/**
+* @file     ir.h
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Header file for ir.c of the interactive memory game between microcontrollers - buffered infra-red
+*/
+
+#ifndef IR_H
+#define IR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ring.h"
+
+#define IR_LOG_BYTES 38 // room for one log frame, stuffed
+
+
+
+/**
+ * Reception and transmission queues of one board's infra-red UART, and
+ * with RECORD the one frame of its log waiting to go out, its length,
+ * or 0 once sent, and how much of it is already on the wire
+ */
+typedef struct {
+    ring_t rx;
+    ring_t tx;
+#ifdef RECORD
+    uint8_t log[ IR_LOG_BYTES ];
+    uint8_t logLength;
+    uint8_t logSent;
+#endif
+    uint16_t dataOverruns;
+} ir_t;
+
+
+/**
+ * Initialiser for the infra-red UART with interrupt driven reception
+ */
+void irInit ( ir_t *ir );
+
+
+/**
+ * Adds a byte recepted by the infra-red UART to the reception buffer.
+ * Called from the USART1 receive interrupt, or by a host build.
+ */
+void irReceiveByte ( ir_t *ir, uint8_t byte );
+
+
+/**
+ * Returns true if a recepted byte is waiting to be read
+ */
+bool irReadReady ( ir_t *ir );
+
+
+/**
+ * Reads the oldest recepted byte, or 0 if none is waiting
+ */
+char irGetc ( ir_t *ir );
+
+
+/**
+ * Queues a byte for infra-red transmission without waiting on the wire.
+ * Returns false, and counts the byte as dropped, if the queue is full.
+ */
+bool irPutc ( ir_t *ir, char byte );
+
+
+#ifdef RECORD
+/**
+ * Returns true once the last frame of the board's log is off the wire
+ */
+bool irLogReady ( ir_t *ir );
+
+
+/**
+ * Holds a frame of the board's log to go out whenever the transmission
+ * queue is empty. Returns false, and holds nothing, if the last frame
+ * is not yet off the wire or this one is too long.
+ */
+bool irPutLog ( ir_t *ir, const uint8_t *bytes, uint8_t length );
+#endif
+
+
+/**
+ * Returns true if the transmission queue has no room for another byte
+ */
+bool irWriteFull ( ir_t *ir );
+
+
+/**
+ * Takes the next queued byte for the wire, returning false if none. A
+ * frame of the log goes out only while the transmission queue is empty,
+ * and a queued byte cuts it short, to be sent again whole. Called from
+ * the USART1 data register empty interrupt, or by a host build.
+ */
+bool irTransmitByte ( ir_t *ir, uint8_t *byte );
+
+
+/**
+ * Returns the number of recepted bytes lost, either to a full
+ * reception buffer or to a USART data overrun
+ */
+uint16_t irOverruns ( ir_t *ir );
+
+
+/**
+ * Returns the number of bytes dropped from a full transmission queue
+ */
+uint16_t irTxDropped ( ir_t *ir );
+#endif
@@ -0,0 +1,354 @@
+/**
+* @file     link.c
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    C program for an interactive memory game between microcontrollers - reliable infra-red link
+*
+* Frames are sent one at a time, stop and wait: the next queued frame is
+* only sent once the one before is acknowledged. Sequence numbers run
+* from LINK_RELIABLE to 0xFF and round again. An acknowledgement is a
+* FRAME_ACK frame with the sequence number of the frame it acknowledges,
+* and that frame's type and CRC as its payload. A frame is acknowledged
+* when the game takes it, not when it arrives, so a frame arriving in a
+* state that does not want it is simply sent again. A recepted frame
+* with the same sequence number and CRC as the last one taken is a
+* retransmission of it, its acknowledgement having been lost, so is only
+* acknowledged again.
+*
+* The CRC is checked as well as the sequence number because a frame that
+* lost a byte still passes its CRC-8 about one time in 256. The game
+* throws such a frame away as malformed, and neither its acknowledgement
+* nor its sequence number then stand in for the good copy after it.
+*/
+
+#include <string.h>
+#include "frame.h"
+#include "link.h"
+
+/**
+ * Initialiser for a link over an infra-red UART, timed by a tick clock
+ */
+void linkInit ( link_t *link, ir_t *ir, const tick_t *tick ) {
+    link->ir = ir;
+    link->tick = tick;
+    link->txSequence = LINK_RELIABLE;
+    link->dump = 0;
+    link->updated = tickMillis ( tick );
+    memset ( &link->stats, 0, sizeof ( link->stats ) );
+    linkReset ( link );
+}
+
+/**
+ * Abandons any frames awaiting acknowledgement and any partly recepted
+ * frame, and forgets the last frame delivered
+ */
+void linkReset ( link_t *link ) {
+    frameReset ( &link->parser );
+    link->head = 0;
+    link->count = 0;
+    link->rxSequence = 0;
+    link->rxCheck = 0;
+    link->delivered = false;
+    link->listenOnly = false;
+    link->unsent = false;
+    link->heard = false;
+}
+
+/**
+ * Stops the link acknowledging frames until linkReset (), but for copies
+ * of the reliable frame last taken before
+ */
+void linkListen ( link_t *link ) {
+    link->listenOnly = true;
+}
+
+/**
+ * Returns the CRC a frame is sent with
+ */
+static uint8_t linkCheck ( const frame_t *frame ) {
+    uint8_t crc = crc8 ( crc8 ( crc8 ( 0, frame->type ), frame->sequence ), frame->length );
+    uint8_t i;
+
+    for ( i = 0; i < frame->length; i++ ) {
+        crc = crc8 ( crc, frame->payload[ i ] );
+    }
+    return crc;
+}
+
+/**
+ * Sends the oldest frame awaiting acknowledgement, and sets when it is
+ * to be sent again if not acknowledged by then, the timeout lengthened
+ * by up to LINK_JITTER by the frame's CRC. With no room for the whole
+ * frame in the transmit ring it is left unsent, rather than cut short,
+ * for linkUpdate () to send once there is.
+ */
+static void linkTransmit ( link_t *link ) {
+    const frame_t *frame = &link->queue[ link->head ];
+
+    link->unsent = !frameRoom ( link->ir, frame->length );
+
+    if ( !link->unsent ) {
+        frameSend ( link->ir, frame->type, frame->sequence, frame->payload, frame->length );
+        deadlineSet ( link->tick, &link->retransmit, link->timeout + linkCheck ( frame ) % LINK_JITTER );
+    }
+}
+
+/**
+ * Queues a frame to be sent until acknowledged, sending it now if no
+ * other frame awaits acknowledgement
+ */
+bool linkSend ( link_t *link, uint8_t type, const uint8_t *payload, uint8_t length ) {
+    frame_t *frame;
+
+    if ( link->count == LINK_QUEUE ) {
+        link->stats.dropped++;
+        return false;
+    }
+    frame = &link->queue[ ( link->head + link->count ) % LINK_QUEUE ];
+    frame->type = type;
+    frame->sequence = link->txSequence;
+    frame->length = length;
+    memcpy ( frame->payload, payload, length );
+    link->txSequence = link->txSequence == 0xFF ? LINK_RELIABLE : link->txSequence + 1;
+
+    if ( link->count++ == 0 ) {
+        link->timeout = LINK_TIMEOUT;
+        link->firstSent = tickMillis ( link->tick );
+        linkTransmit ( link );
+    }
+    return true;
+}
+
+/**
+ * Queues a one char message to be sent until acknowledged
+ */
+bool linkPutc ( link_t *link, char message ) {
+    uint8_t payload = message;
+
+    return linkSend ( link, FRAME_MESSAGE, &payload, 1 );
+}
+
+/**
+ * Returns true once every frame sent has been acknowledged
+ */
+bool linkIdle ( const link_t *link ) {
+    return link->count == 0;
+}
+
+/**
+ * Takes the oldest frame off the queue once acknowledged, noting how
+ * long it took from first being sent, and its round trip if it was not
+ * sent again, then sends the next if any
+ */
+static void linkAcknowledged ( link_t *link ) {
+    uint32_t delivery = tickMillis ( link->tick ) - link->firstSent;
+    uint32_t bound = LINK_RTT_FIRST;
+    uint8_t bucket = 0;
+
+    if ( delivery > link->stats.longestDelivery ) {
+        link->stats.longestDelivery = delivery > UINT16_MAX ? UINT16_MAX : delivery;
+    }
+
+    if ( link->timeout == LINK_TIMEOUT ) {
+        while ( ( bucket < LINK_RTT_BUCKETS - 1 ) && ( delivery >= bound ) ) {
+            bucket++;
+            bound <<= 1;
+        }
+        link->stats.rtt[ bucket ]++;
+    }
+    link->head = ( link->head + 1 ) % LINK_QUEUE;
+
+    if ( --link->count ) {
+        link->timeout = LINK_TIMEOUT;
+        link->firstSent = tickMillis ( link->tick );
+        linkTransmit ( link );
+    }
+}
+
+/**
+ * Acknowledges the reliable frame just recepted. With no room for the
+ * acknowledgement in the transmit ring it is not sent, as the frame
+ * will be sent again and acknowledged then.
+ */
+static void linkAcknowledge ( link_t *link ) {
+    const frame_t *frame = &link->parser.frame;
+    uint8_t payload[ LINK_ACK_PAYLOAD ] = { frame->type, link->parser.crc };
+
+    if ( frameRoom ( link->ir, LINK_ACK_PAYLOAD ) ) {
+        frameSend ( link->ir, FRAME_ACK, frame->sequence, payload, LINK_ACK_PAYLOAD );
+    }
+}
+
+/**
+ * Handles a whole recepted frame: an acknowledgement of the frame
+ * awaiting one, a copy of the reliable frame last taken to acknowledge
+ * again, or a frame to deliver
+ */
+static void linkFrame ( link_t *link ) {
+    const frame_t *frame = &link->parser.frame;
+    const frame_t *waiting = &link->queue[ link->head ];
+
+    if ( frame->type == FRAME_ACK ) {
+        link->heard = true;
+
+        if ( link->count && ( frame->length == LINK_ACK_PAYLOAD ) && ( frame->sequence == waiting->sequence )
+                && ( frame->payload[ 0 ] == waiting->type ) && ( frame->payload[ 1 ] == linkCheck ( waiting ) ) ) {
+            linkAcknowledged ( link );
+        } else {
+            link->stats.mismatches++;
+        }
+    } else if ( ( frame->sequence & LINK_RELIABLE ) && ( frame->sequence == link->rxSequence )
+                && ( link->parser.crc == link->rxCheck ) ) {
+        link->stats.duplicates++;
+        linkAcknowledge ( link );
+    } else {
+        link->delivered = true;
+    }
+}
+
+/**
+ * Sends the oldest frame awaiting acknowledgement if it was left unsent
+ * and the transmit ring now has room for it, or retransmits it if its
+ * timeout has passed and the ring has room, doubling the timeout up to
+ * LINK_TIMEOUT_MAX. Then recepts bytes until a frame is
+ * delivered or none are left, counting the time since the last update
+ * as idle if there were none and nothing is waiting to be transmitted.
+ */
+void linkUpdate ( link_t *link ) {
+    const frame_t *waiting = &link->queue[ link->head ];
+    uint16_t now = tickMillis ( link->tick );
+
+    if ( link->delivered ) {
+        link->stats.unexpected++;
+        link->delivered = false;
+    }
+
+    if ( !irReadReady ( link->ir ) && !ringCount ( &link->ir->tx ) ) {
+        link->stats.idle += ( uint16_t ) ( now - link->updated );
+    }
+    link->updated = now;
+
+    if ( link->count && link->unsent ) {
+        linkTransmit ( link );
+    } else if ( link->count && deadlineExpired ( link->tick, &link->retransmit )
+                && frameRoom ( link->ir, waiting->length ) ) {
+        link->timeout = link->timeout * 2 > LINK_TIMEOUT_MAX ? LINK_TIMEOUT_MAX : link->timeout * 2;
+        link->stats.retransmissions++;
+        linkTransmit ( link );
+    }
+
+    while ( !link->delivered && irReadReady ( link->ir ) ) {
+        link->stats.discarded++;
+
+        if ( frameReceive ( &link->parser, irGetc ( link->ir ) ) ) {
+            link->stats.discarded -= FRAME_OVERHEAD + link->parser.frame.length;
+            linkFrame ( link );
+        }
+        link->stats.discarded -= frameSkipped ( &link->parser );
+    }
+}
+
+/**
+ * Takes the frame delivered this tick, returning 0 if there is none.
+ * A reliable frame is acknowledged once taken, unless only listening,
+ * so one delivered while the game is in no state to take it is sent
+ * again later.
+ */
+const frame_t *linkReceive ( link_t *link ) {
+    const frame_t *frame = &link->parser.frame;
+
+    if ( !link->delivered ) {
+        return 0;
+    }
+    link->delivered = false;
+
+    if ( ( frame->sequence & LINK_RELIABLE ) && !link->listenOnly ) {
+        link->rxSequence = frame->sequence;
+        link->rxCheck = link->parser.crc;
+        linkAcknowledge ( link );
+    }
+    return frame;
+}
+
+/**
+ * Returns the frame delivered this tick without taking it, or 0 if
+ * there is none. Left untaken, a reliable frame is not acknowledged.
+ */
+const frame_t *linkPeek ( const link_t *link ) {
+    return link->delivered ? &link->parser.frame : 0;
+}
+
+/**
+ * Returns true once an acknowledgement has been recepted since
+ * linkReset (), of whichever board's frame: one board has sent a frame
+ * and another taken it
+ */
+bool linkHeard ( const link_t *link ) {
+    return link->heard;
+}
+
+/**
+ * Counts a frame taken by the game as unexpected, as it has no use for it
+ */
+void linkUnexpected ( link_t *link ) {
+    link->stats.unexpected++;
+}
+
+/**
+ * Returns the link's counts
+ */
+const link_stats_t *linkStats ( const link_t *link ) {
+    return &link->stats;
+}
+
+/**
+ * Starts sending the link's counts over infra-red
+ */
+void linkDump ( link_t *link ) {
+    if ( !link->dump ) {
+        link->dump = LINK_STATS_FRAMES;
+    }
+}
+
+/**
+ * Sends the next frame of a dump of the link's counts if the transmit
+ * ring has room for it
+ */
+void linkDumpUpdate ( link_t *link ) {
+    const link_stats_t *stats = &link->stats;
+    uint8_t frame = LINK_STATS_FRAMES - link->dump;
+    uint16_t others[ LINK_STATS_PAYLOAD / 2 ];
+    const uint16_t *counts = frame == 0 ? stats->rtt : others;
+    uint8_t payload[ LINK_STATS_PAYLOAD ];
+    uint8_t i;
+
+    if ( !link->dump || !frameRoom ( link->ir, LINK_STATS_PAYLOAD ) ) {
+        return;
+    }
+    others[ 0 ] = stats->retransmissions;
+    others[ 1 ] = stats->duplicates;
+    others[ 2 ] = stats->dropped;
+    others[ 3 ] = stats->mismatches;
+    others[ 4 ] = stats->unexpected;
+    others[ 5 ] = stats->discarded;
+    others[ 6 ] = stats->longestDelivery;
+    others[ 7 ] = stats->idle / 1000;
+
+    for ( i = 0; i < LINK_STATS_PAYLOAD / 2; i++ ) {
+        payload[ i * 2 ] = counts[ i ];
+        payload[ i * 2 + 1 ] = counts[ i ] >> 8;
+    }
+    frameSend ( link->ir, FRAME_LINK_STATS, frame, payload, LINK_STATS_PAYLOAD );
+    link->dump--;
+}
+
+/**
+ * Returns the char of a one char message frame, or 0 if the frame is
+ * not one, or there is no frame
+ */
+char linkMessage ( const frame_t *frame ) {
+    if ( !frame || ( frame->type != FRAME_MESSAGE ) || ( frame->length != 1 ) ) {
+        return 0;
+    }
+    return frame->payload[ 0 ];
+}
@@ -0,0 +1,179 @@
+/**
+* @file     link.h
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Header file for link.c of the interactive memory game between microcontrollers - reliable infra-red link
+*
+* Every game message is a frame. A frame sent with linkSend () carries a
+* sequence number with LINK_RELIABLE set, and is sent again, each time
+* after twice as long, until the other board acknowledges it. The other
+* board acknowledges it once taken, and every copy after, but only
+* delivers the first, so a lost byte costs a retransmission rather than
+* a stuck game. Frames
+* with LINK_RELIABLE clear are delivered as they come, unacknowledged.
+*/
+
+#ifndef LINK_H
+#define LINK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tick.h"
+#include "ir.h"
+#include "frame.h"
+
+#define LINK_QUEUE 4 // frames awaiting acknowledgement: a failed RECEIVER may have "Y", "T", "R" then a difficulty
+#define LINK_RELIABLE 0x80 // set in the sequence number of an acknowledged frame
+#define LINK_TIMEOUT 250 // ms before the first retransmission
+#define LINK_TIMEOUT_MAX 1000 // ms, the longest backoff
+#define LINK_JITTER 64 // ms a timeout is lengthened by at most, so two boards retransmitting on one channel fall out of step
+#define LINK_ACK_PAYLOAD 2
+#define LINK_RTT_BUCKETS 8 // round trips under 16, 32, 64 ... 1024 ms, then longer
+#define LINK_RTT_FIRST 16 // ms, the bound of the first bucket
+#define LINK_STATS_FRAMES 2
+#define LINK_STATS_PAYLOAD 16
+#define FRAME_MESSAGE 'G'
+#define FRAME_LINK_STATS 'S'
+
+
+/**
+ * Counts of how well the link is doing since linkInit (). Round trips
+ * are only timed for frames acknowledged first time, as the ack of a
+ * retransmitted frame may answer an earlier copy. Mismatches are
+ * acknowledgements of no frame awaiting one: late, repeated or damaged.
+ * Unexpected frames arrived in a state with no use for them. Discarded
+ * bytes were not part of any good frame, nor of a log frame passed
+ * over. Idle is milliseconds with no byte recepted or waiting to be
+ * transmitted.
+ */
+typedef struct {
+    uint16_t rtt[ LINK_RTT_BUCKETS ];
+    uint16_t retransmissions, duplicates, dropped, mismatches, unexpected, discarded, longestDelivery;
+    uint32_t idle;
+} link_stats_t;
+
+
+/**
+ * The frames of one board's link awaiting acknowledgement, the oldest
+ * being the one sent, and the reception of frames from the other board
+ */
+typedef struct {
+    ir_t *ir;
+    const tick_t *tick;
+    frame_parser_t parser;
+    frame_t queue[ LINK_QUEUE ];
+    uint8_t head, count;
+    uint8_t txSequence, rxSequence, rxCheck;
+    bool delivered : 1, listenOnly : 1, unsent : 1, heard : 1;
+    uint8_t dump;
+    uint16_t timeout, updated;
+    deadline_t retransmit;
+    uint32_t firstSent;
+    link_stats_t stats;
+} link_t;
+
+
+/**
+ * Initialiser for a link over an infra-red UART, timed by a tick clock
+ */
+void linkInit ( link_t *link, ir_t *ir, const tick_t *tick );
+
+
+/**
+ * Abandons any frames awaiting acknowledgement and any partly recepted
+ * frame, and forgets the last frame delivered
+ */
+void linkReset ( link_t *link );
+
+
+/**
+ * Stops the link acknowledging frames, so a board can listen to frames
+ * between other boards without answering them, until linkReset (). Copies
+ * of the reliable frame last taken before are still acknowledged.
+ */
+void linkListen ( link_t *link );
+
+
+/**
+ * Queues a frame to be sent until acknowledged. Returns false, and
+ * counts the frame as dropped, if LINK_QUEUE frames already await.
+ */
+bool linkSend ( link_t *link, uint8_t type, const uint8_t *payload, uint8_t length );
+
+
+/**
+ * Queues a one char message to be sent until acknowledged
+ */
+bool linkPutc ( link_t *link, char message );
+
+
+/**
+ * Returns true once every frame sent has been acknowledged
+ */
+bool linkIdle ( const link_t *link );
+
+
+/**
+ * Retransmits the oldest frame awaiting acknowledgement if its timeout
+ * has passed, and recepts bytes until a frame is delivered or none are
+ * left. Called once per pacer tick; a frame delivered on the previous
+ * tick and not taken is discarded.
+ */
+void linkUpdate ( link_t *link );
+
+
+/**
+ * Takes the frame delivered this tick, returning 0 if there is none,
+ * and acknowledges it if reliable
+ */
+const frame_t *linkReceive ( link_t *link );
+
+
+/**
+ * Returns the frame delivered this tick without taking it, or 0 if
+ * there is none
+ */
+const frame_t *linkPeek ( const link_t *link );
+
+
+/**
+ * Returns true once an acknowledgement has been recepted since
+ * linkReset (), of whichever board's frame: one board has sent a frame
+ * and another taken it
+ */
+bool linkHeard ( const link_t *link );
+
+
+/**
+ * Counts a frame taken by the game as unexpected, as it has no use for it
+ */
+void linkUnexpected ( link_t *link );
+
+
+/**
+ * Returns the link's counts
+ */
+const link_stats_t *linkStats ( const link_t *link );
+
+
+/**
+ * Starts sending the link's counts over infra-red, unacknowledged, in
+ * LINK_STATS_FRAMES frames: the round trip buckets, then the other
+ * counts in order with idle in whole seconds, each low byte first
+ */
+void linkDump ( link_t *link );
+
+
+/**
+ * Sends the next frame of a dump of the link's counts if the transmit
+ * ring has room for it
+ */
+void linkDumpUpdate ( link_t *link );
+
+
+/**
+ * Returns the char of a one char message frame, or 0 if the frame is
+ * not one, or there is no frame
+ */
+char linkMessage ( const frame_t *frame );
+#endif
@@ -0,0 +1,99 @@
+/**
+* @file     matrix.c
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    C program for an interactive memory game between microcontrollers - LED matrix refresh
+*/
+
+#include "ledmat.h"
+#include "matrix.h"
+#include "pace.h"
+#include <string.h>
+
+#ifdef __AVR__
+#include "timer.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+
+#define SCAN_PERIOD ( TIMER_RATE / MATRIX_SCAN_RATE ) // timer ticks
+
+static matrix_t *screen;
+
+/**
+ * Shows the next column of the front frame. Timer 1 runs free for the
+ * pacer, so compare A is moved on a period at a time rather than the
+ * timer being cleared. The write goes through timer 1's TEMP register,
+ * so code outside an interrupt reads the timer with paceTimer ().
+ */
+ISR ( TIMER1_COMPA_vect ) {
+    uint8_t column;
+    uint8_t pattern;
+
+    OCR1A += SCAN_PERIOD;
+    pattern = matrixScan ( screen, &column );
+    ledmat_display_column ( pattern, column );
+}
+#endif
+
+/**
+ * Initialiser for the LED matrix and a blank pair of frames. On AVR
+ * this starts the scan interrupt.
+ */
+void matrixInit ( matrix_t *matrix ) {
+    memset ( matrix->columns, 0, sizeof ( matrix->columns ) );
+    matrix->front = 0;
+    matrix->scan = 0;
+    matrix->swapPending = false;
+    ledmat_init ();
+#ifdef __AVR__
+    screen = matrix;
+
+    ATOMIC_BLOCK ( ATOMIC_RESTORESTATE ) {
+        OCR1A = TCNT1 + SCAN_PERIOD;
+    }
+    TIFR1 = _BV ( OCF1A );
+    TIMSK1 |= _BV ( OCIE1A );
+    sei ();
+#endif
+}
+
+/**
+ * Returns true if the back frame may be drawn: false from a swap until
+ * the scan has started showing it
+ */
+bool matrixReady ( const matrix_t *matrix ) {
+    return !matrix->swapPending;
+}
+
+/**
+ * Returns the back frame's columns, to draw a whole frame into
+ */
+uint8_t *matrixBack ( matrix_t *matrix ) {
+    return matrix->columns[ matrix->front ^ 1 ];
+}
+
+/**
+ * Shows the back frame once the scan next starts at column 0
+ */
+void matrixSwap ( matrix_t *matrix ) {
+    matrix->swapPending = true;
+}
+
+/**
+ * Moves the scan on by a column, swapping frames first if one is
+ * waiting and the scan is at column 0. Returns the pattern of the front
+ * frame's column, and sets column to the column to show it in.
+ */
+uint8_t matrixScan ( matrix_t *matrix, uint8_t *column ) {
+    if ( ( matrix->scan == 0 ) && matrix->swapPending ) {
+        matrix->front ^= 1;
+        matrix->swapPending = false;
+    }
+    *column = matrix->scan;
+
+    if ( ++matrix->scan == DISPLAY_WIDTH ) {
+        matrix->scan = 0;
+    }
+    return matrix->columns[ matrix->front ][ *column ];
+}
@@ -0,0 +1,68 @@
+/**
+* @file     matrix.h
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Header file for matrix.c of the interactive memory game between microcontrollers - LED matrix refresh
+*
+* The LED matrix is scanned a column at a time by a timer interrupt, at
+* MATRIX_SCAN_RATE columns per second whatever the game loop is doing,
+* from the front of two frame buffers. The game draws whole frames into
+* the back buffer and swaps, and the swap takes effect when the scan
+* next starts at column 0, so a frame is never shown half drawn.
+*/
+
+#ifndef MATRIX_H
+#define MATRIX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "display.h"
+
+#define MATRIX_SCAN_RATE ( DISPLAY_WIDTH * 100 ) // columns per second, refreshing at 100 Hz
+
+
+/**
+ * Two frames of column patterns, row 0 the low bit, the scan's next
+ * column, and whether the back frame is waiting to be shown
+ */
+typedef struct {
+    uint8_t columns[ 2 ][ DISPLAY_WIDTH ];
+    uint8_t front;
+    uint8_t scan;
+    volatile bool swapPending;
+} matrix_t;
+
+
+/**
+ * Initialiser for the LED matrix and a blank pair of frames. On AVR
+ * this starts the scan interrupt.
+ */
+void matrixInit ( matrix_t *matrix );
+
+
+/**
+ * Returns true if the back frame may be drawn: false from a swap until
+ * the scan has started showing it
+ */
+bool matrixReady ( const matrix_t *matrix );
+
+
+/**
+ * Returns the back frame's columns, to draw a whole frame into
+ */
+uint8_t *matrixBack ( matrix_t *matrix );
+
+
+/**
+ * Shows the back frame once the scan next starts at column 0
+ */
+void matrixSwap ( matrix_t *matrix );
+
+
+/**
+ * Moves the scan on by a column, swapping frames first if one is
+ * waiting and the scan is at column 0. Returns the pattern of the front
+ * frame's column, and sets column to the column to show it in.
+ */
+uint8_t matrixScan ( matrix_t *matrix, uint8_t *column );
+#endif
@@ -0,0 +1,145 @@
+/**
+* @file     pace.c
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    C program for an interactive memory game between microcontrollers - sleeping pacer
+*
+* Compare C of the free-running timer 1 is set to when the next pass is
+* due, so the CPU wakes on time even with no other interrupt near it.
+* Interrupts are disabled while checking the time and re-enabled just
+* before sleeping, as the instruction after sei always runs before any
+* interrupt, so one arriving between the check and the sleep still wakes
+* it. Pin change interrupts are not used for the navswitch: idle sleep
+* keeps the sampling interrupt running, and deeper sleep modes would stop
+* the timer the matrix scan runs from.
+*/
+
+#include <string.h>
+#include "frame.h"
+#include "pace.h"
+
+#define PACE_PAYLOAD 12
+
+#ifdef __AVR__
+#include "timer.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include <util/atomic.h>
+
+/**
+ * Only wakes the CPU when a pass is due
+ */
+EMPTY_INTERRUPT ( TIMER1_COMPC_vect )
+
+/**
+ * Reads timer 1 with interrupts masked, so no interrupt's write of a
+ * compare register changes the TEMP register between its two bytes
+ */
+uint16_t paceTimer ( void ) {
+    timer_tick_t now;
+
+    ATOMIC_BLOCK ( ATOMIC_RESTORESTATE ) {
+        now = timer_get ();
+    }
+    return now;
+}
+#endif
+
+/**
+ * Initialiser for pacing the game loop at a number of passes a second.
+ * On AVR this starts timer 1 and the wake-up interrupt.
+ */
+void paceInit ( pace_t *pace, uint16_t rate ) {
+    memset ( &pace->stats, 0, sizeof ( pace->stats ) );
+    pace->dump = 0;
+    paceRate ( pace, rate );
+#ifdef __AVR__
+    timer_init ();
+    pace->due = paceTimer ();
+    pace->woke = pace->due;
+    set_sleep_mode ( SLEEP_MODE_IDLE );
+    TIFR1 = _BV ( OCF1C );
+    TIMSK1 |= _BV ( OCIE1C );
+#endif
+}
+
+/**
+ * Changes the loop rate, from the next wait on
+ */
+void paceRate ( pace_t *pace, uint16_t rate ) {
+    pace->rate = rate;
+#ifdef __AVR__
+    pace->period = TIMER_RATE / rate;
+#endif
+}
+
+/**
+ * Sleeps until the next pass of the game loop is due, counting the time
+ * since the CPU last woke as awake. If the last pass overran, the next
+ * starts at once, and passes catch up as with the UCFK4 pacer.
+ */
+void paceWait ( pace_t *pace ) {
+#ifdef __AVR__
+    timer_tick_t slept;
+
+    pace->due += pace->period;
+
+    ATOMIC_BLOCK ( ATOMIC_RESTORESTATE ) {
+        OCR1C = pace->due;
+    }
+    slept = paceTimer ();
+    pace->stats.awake += ( timer_tick_t ) ( slept - pace->woke );
+
+    while ( 1 ) {
+        cli ();
+
+        if ( ( int16_t ) ( paceTimer () - pace->due ) >= 0 ) {
+            break;
+        }
+        sleep_enable ();
+        sei ();
+        sleep_cpu ();
+        sleep_disable ();
+        sei ();
+    }
+    sei ();
+    pace->woke = paceTimer ();
+    pace->stats.asleep += ( timer_tick_t ) ( pace->woke - slept );
+#endif
+    pace->stats.passes++;
+}
+
+/**
+ * Returns the loop's time asleep and awake, and its passes
+ */
+const pace_stats_t *paceStats ( const pace_t *pace ) {
+    return &pace->stats;
+}
+
+/**
+ * Starts sending the loop's counts over infra-red
+ */
+void paceDump ( pace_t *pace ) {
+    pace->dump = 1;
+}
+
+/**
+ * Sends a dump of the loop's counts if one is due and the transmit
+ * ring has room for it
+ */
+void paceDumpUpdate ( pace_t *pace, ir_t *ir ) {
+    const uint32_t counts[] = { pace->stats.asleep, pace->stats.awake, pace->stats.passes };
+    uint8_t payload[ PACE_PAYLOAD ];
+    uint8_t i;
+
+    if ( !pace->dump || !frameRoom ( ir, PACE_PAYLOAD ) ) {
+        return;
+    }
+
+    for ( i = 0; i < PACE_PAYLOAD; i++ ) {
+        payload[ i ] = counts[ i / 4 ] >> ( i % 4 * 8 );
+    }
+    frameSend ( ir, FRAME_PACE, 0, payload, PACE_PAYLOAD );
+    pace->dump = 0;
+}
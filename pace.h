@@ -0,0 +1,94 @@
+/**
+* @file     pace.h
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Header file for pace.c of the interactive memory game between microcontrollers - sleeping pacer
+*
+* Paces the game loop like the UCFK4 pacer, but sleeps between passes
+* rather than spinning on timer 1. Idle sleep keeps the timer and the
+* USART running, so the matrix scan, navswitch sample and infra-red
+* interrupts carry on and wake the CPU, which goes back to sleep until
+* the next pass is due. The loop rate can be changed as the game runs.
+*/
+
+#ifndef PACE_H
+#define PACE_H
+
+#include <stdint.h>
+#include "ir.h"
+
+#define FRAME_PACE 'Z'
+
+
+/**
+ * How the game loop has spent its time since paceInit (), in timer 1
+ * ticks: asleep waiting for a pass, counting the interrupts that wake it,
+ * and awake running passes. A host build only counts passes.
+ */
+typedef struct {
+    uint32_t asleep, awake, passes;
+} pace_stats_t;
+
+
+/**
+ * The loop rate, when the next pass is due and when the CPU last woke
+ */
+typedef struct {
+    uint16_t rate, period, due, woke;
+    uint8_t dump;
+    pace_stats_t stats;
+} pace_t;
+
+
+/**
+ * Initialiser for pacing the game loop at a number of passes a second.
+ * On AVR this starts timer 1, so is called before the interrupts run
+ * from it are set up.
+ */
+void paceInit ( pace_t *pace, uint16_t rate );
+
+
+/**
+ * Changes the loop rate, from the next wait on
+ */
+void paceRate ( pace_t *pace, uint16_t rate );
+
+
+/**
+ * Sleeps until the next pass of the game loop is due
+ */
+void paceWait ( pace_t *pace );
+
+
+/**
+ * Returns the loop's time asleep and awake, and its passes
+ */
+const pace_stats_t *paceStats ( const pace_t *pace );
+
+
+/**
+ * Starts sending the loop's counts over infra-red, unacknowledged, in
+ * one frame: asleep, awake, then passes, each four bytes low first
+ */
+void paceDump ( pace_t *pace );
+
+
+/**
+ * Sends a dump of the loop's counts if one is due and the transmit
+ * ring has room for it
+ */
+void paceDumpUpdate ( pace_t *pace, ir_t *ir );
+
+
+#ifdef __AVR__
+/**
+ * Reads timer 1 with interrupts masked. The matrix scan and navswitch
+ * sample interrupts write their compare registers through the TEMP
+ * register a 16 bit read of the count shares, so one of them coming
+ * between the read's two bytes would change its high byte. Every read
+ * of timer 1 outside an interrupt, and every write of its registers, is
+ * made this way.
+ */
+uint16_t paceTimer ( void );
+#endif
+#endif
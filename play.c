@@ -3,25 +3,36 @@
 * @authors  Adam Ross
 * @date     12 Oct 2016
 * @brief    C program for an interactive memory game between microcontrollers - gameplay
+*
+* Game play for both players is one state machine. Each state has a row
+* in stateTable giving the message scrolled while in it, an entry action
+* and an update run once per pacer tick. No update loops or waits, so a
+* tick acts on at most one queued navswitch press, one infra-red reception, one
+* infra-red transmission and one display change, whatever the state.
+* Every message between the boards goes over the reliable link, so is
+* sent again until acknowledged.
 */
 
-#include "ir_uart.h"
-#include "pacer.h"
 #include "led.h"
 #include "pio.h"
 #include "navswitch.h"
-#include "tinygl.h"
-#include "disp.h"
+#include "input.h"
+#include "play.h"
+#include "flash.h"
+#include "prof.h"
+#include "trace.h"
+#include "tourn.h"
+#include "link.h"
+#include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 
-#define MAXIMUM_DIRECTIONS 8
-#define MAX_SPEED 200
-#define PAUSE 400
+#define MAX_SPEED 200 // ms
+#define PAUSE 400 // ms
+#define LED_FLASH 500 // ms
 #define LVL_ONE 'A'
-#define LVL_TWO 'B'
 #define LVL_THREE 'C'
 #define CHANGE_PLAY 'Y'
-#define START_NEW_GAME 'V'
 #define RESET '-'
 #define RESIGN 'X'
 #define NORTH 'N'
@@ -31,555 +42,864 @@
 #define SENDER '$'
 #define RECEIVER 'R'
 
-const char GAME_FAIL[] = "YOU FAILED";
-const char GAME_WIN[] = "YOU WON!";
-const char LVL_CHOOSE[] = "CHOOSE LEVEL 1-3";
-const char GAME_START[] = "START GAME";
-const char RECEIVER_START[] = "PLAY DIRECTIONS";
-const char LEVEL_WON[] = "GAME LEVEL WON!";
-const char GO[] = "GO";
+const char GAME_FAIL[] PROGMEM = "YOU FAILED";
+const char GAME_WIN[] PROGMEM = "YOU WON!";
+const char LVL_CHOOSE[] PROGMEM = "CHOOSE LEVEL 1-3";
+const char GAME_START[] PROGMEM = "START GAME";
+const char RECEIVER_START[] PROGMEM = "PLAY DIRECTIONS";
+const char LEVEL_WON[] PROGMEM = "GAME LEVEL WON!";
+const char GO[] PROGMEM = "GO";
 
-char directionsArray[MAXIMUM_DIRECTIONS] = { 0 };
+_Static_assert ( FRAME_OVERHEAD + FRAME_PAYLOAD_MAX <= RING_SIZE, "the longest frame overflows the infra-red queues" );
 
-char difficulty = LVL_ONE, gameLevel = LVL_ONE, count = 'A', direction;
+/**
+ * A row of the state table. If message is set it is scrolled from flash
+ * on entry, before enter is run, and next is the state moved to when the
+ * navswitch is pushed by awaitPush. Update returns the state to be in.
+ * The table is kept in flash, and a row copied out with stateRow ().
+ */
+typedef struct {
+    const char *message;
+    uint8_t next;
+    void ( *enter ) ( game_t *game );
+    uint8_t ( *update ) ( game_t *game );
+} state_t;
 
-int score = 0, directionsTransmitted = 0, numberOfDirections = MAXIMUM_DIRECTIONS / 2, displaySpeed;
+extern const state_t stateTable[ STATE_COUNT ] PROGMEM;
 
-bool activityComplete = false, parametersConfirmed = false, allDirectionsRepeated = false, recepted = true;
+/**
+ * Copies a state's row of the state table out of flash
+ */
+void stateRow ( uint8_t state, state_t *row ) {
+    FLASH_READ_BLOCK ( row, &stateTable[ state ], sizeof ( *row ) );
+}
 
 /**
- * Because the game difficulty chosen by SENDER at game start is
- * converted to a corresponding char for data transmission,
- * it must be re-converted back to an interger for game play
- * parameter setting after infra-red reception at RECEIVER board
+ * A row of the level table: the number of directions played at the
+ * level, up to MAXIMUM_DIRECTIONS, and the digit SENDER is shown while
+ * entering them
  */
-void convertDifficultyToInt ( void ) {
-    if ( difficulty == LVL_ONE ) {
-        displaySpeed = PAUSE * 2 + MAX_SPEED;
-    } else if ( difficulty == LVL_TWO ) {
-        displaySpeed = PAUSE + MAX_SPEED;
-    } else if ( difficulty == LVL_THREE ) {
-        displaySpeed = MAX_SPEED;
-    }
+typedef struct {
+    uint8_t directions;
+    char glyph;
+} level_t;
+
+/**
+ * The levels, from dirs.h's LEVEL_ROWS, each checked to fit directions_t
+ */
+#define LEVEL_CHECK(directions, glyph) \
+    _Static_assert ( ( directions ) > 0 && ( directions ) <= MAXIMUM_DIRECTIONS, "level " #glyph " overflows directions_t" );
+#define LEVEL_ROW(directions, glyph) { directions, glyph },
+
+LEVEL_ROWS ( LEVEL_CHECK )
+
+const level_t levelTable[] PROGMEM = { LEVEL_ROWS ( LEVEL_ROW ) };
+
+/**
+ * The milliseconds each direction is displayed for at each difficulty,
+ * from LVL_ONE on, easiest first
+ */
+const uint16_t difficultyTable[] PROGMEM = { PAUSE * 2 + MAX_SPEED, PAUSE + MAX_SPEED, MAX_SPEED };
+
+#define LEVELS ( ( uint8_t ) ( sizeof ( levelTable ) / sizeof ( levelTable[ 0 ] ) ) )
+#define DIFFICULTIES ( ( uint8_t ) ( sizeof ( difficultyTable ) / sizeof ( difficultyTable[ 0 ] ) ) )
+#define LVL_LAST ( LVL_ONE + LEVELS - 1 )
+#define DIFFICULTY_LAST ( LVL_ONE + DIFFICULTIES - 1 )
+
+_Static_assert ( LEVELS == REACT_LEVELS, "react.h needs a reaction time cell per level" );
+_Static_assert ( DIFFICULTIES == REACT_DIFFICULTIES, "react.h needs a reaction time cell per difficulty" );
+
+/**
+ * Because the game->difficulty chosen by SENDER is transmitted as a
+ * char, RECEIVER looks up the milliseconds each direction is displayed
+ * for from it, as SENDER does
+ */
+void difficultyLoad ( game_t *game ) {
+    game->displayTime = FLASH_READ_WORD ( &difficultyTable[ game->difficulty - LVL_ONE ] );
 }
 
 /**
- * Converts a char to an integer value equal to the number of
- * directions for the gameLevel level the char is representative of
+ * Looks up the number of game->directions played at game->gameLevel
  */
-void convertGameLeveltoInt ( void ) {
-    if ( gameLevel == LVL_ONE ) {
-        numberOfDirections = MAXIMUM_DIRECTIONS / 2;
-    } else if ( gameLevel == LVL_TWO ) {
-        numberOfDirections = MAXIMUM_DIRECTIONS - 2;
-    } else if ( gameLevel == LVL_THREE ) {
-        numberOfDirections = MAXIMUM_DIRECTIONS;
-    }
+void levelLoad ( game_t *game ) {
+    game->numberOfDirections = FLASH_READ_BYTE ( &levelTable[ game->gameLevel - LVL_ONE ].directions );
 }
 
 /**
- * A simple loop to delay run time of game for display purposes
+ * Moves the game to a level
  */
-void timerDelay ( char *directionChar, int *time ) {
-    long delay = 0;
-    long delayTime = *time;
+void levelSet ( game_t *game, char level ) {
+    game->gameLevel = level;
+    TRACE_EVENT ( TRACE_LEVEL, level );
+}
 
-    while ( delay < delayTime ) {
-        displayChar ( directionChar );
-        delay++;
+/**
+ * Returns true if this tick's navswitch press is of a switch, taking it if so
+ */
+bool navPushed ( game_t *game, uint8_t navswitch ) {
+    if ( game->event.navswitch == navswitch ) {
+        game->event.navswitch = INPUT_NONE;
+        return true;
     }
+    return false;
 }
 
 /**
- * Sets a char with the max number of directions
- * for the round of the game for displaying purposes
+ * Returns the direction the navswitch has been moved in this tick, if any
  */
-void displayNumberOfDirections ( char *charInput ) {
-    if ( numberOfDirections == MAXIMUM_DIRECTIONS ) {
-        *charInput = '8';
-    } else if ( numberOfDirections == MAXIMUM_DIRECTIONS - 2 ) {
-        *charInput = '6';
-    } else if ( numberOfDirections == MAXIMUM_DIRECTIONS / 2 ) {
-        *charInput = '4';
+char navDirection ( game_t *game ) {
+    if ( navPushed ( game, NAVSWITCH_NORTH ) ) {
+        return NORTH;
+    } else if ( navPushed ( game, NAVSWITCH_SOUTH ) ) {
+        return SOUTH;
+    } else if ( navPushed ( game, NAVSWITCH_EAST ) ) {
+        return EAST;
+    } else if ( navPushed ( game, NAVSWITCH_WEST ) ) {
+        return WEST;
     }
+    return 0;
 }
 
 /**
- * The SENDER player enters the directions to be sent to the RECEIVER
- * player by moving the navswitch in any direction until the total
- * number of directions to be played have been chosen.
- * So long as not all directions permitted are given, player SENDER can
- * reset the input of directions by pressing the navswitch button down.
- */
-void chooseSendingDirections ( void ) {
-    int inputCount = 0;
-    char charInput;
-    convertGameLeveltoInt ();
-    displayNumberOfDirections ( &charInput );
-
-    while ( inputCount < numberOfDirections ) {
-        pacer_wait ();
-        tinygl_update ();
-        navswitch_update ();
-
-        if ( navswitch_push_event_p ( NAVSWITCH_NORTH ) ) {
-            charInput = directionsArray[ inputCount ] = NORTH;
-            inputCount++;
-        } else if ( navswitch_push_event_p ( NAVSWITCH_SOUTH ) ) {
-            charInput = directionsArray[ inputCount ] = SOUTH;
-            inputCount++;
-        } else if ( navswitch_push_event_p ( NAVSWITCH_EAST ) ) {
-            charInput = directionsArray[ inputCount ] = EAST;
-            inputCount++;
-        } else if ( navswitch_push_event_p ( NAVSWITCH_WEST ) ) {
-            charInput = directionsArray[ inputCount ] = WEST;
-            inputCount++;
-        } else if ( navswitch_push_event_p ( NAVSWITCH_PUSH ) ) {
-            charInput = RESET;
-            inputCount = 0;
-        }
-        displayChar ( &charInput );
+ * Returns true if the navswitch has been pushed while a message is
+ * scrolling, and if so stops the scrolling
+ */
+bool scrollPushed ( game_t *game ) {
+    if ( navPushed ( game, NAVSWITCH_PUSH ) ) {
+        displayClear ( &game->disp );
+        return true;
     }
+    return false;
 }
 
 /**
- * Checks if each attempt made at repeating direction by RECEIVER player
- * is a correct choice, and increments score if so, and attempt count
- */
-void attemptEvaluation ( char *attempt, int *attemptNum ) {
-    displayChar ( attempt );
-
-    if ( directionsArray[ *attemptNum ] == *attempt ) {
-        score++;
-    }
-    *attemptNum += 1;
-}
-
-/**
- * Player RECEIVER attempts to repeat directions given by player SENDER.
- * A score count is implemented for each successful direction repeated
- * by player RECEIVER and the final score is returned once all attempts at
- * repeating the given directions have been completed.
- */
-void repeatDirections ( void ) {
-    int attemptCount = 0, pause = PAUSE;
-    char repeatAttempt = '*';
-    continuousScroll ( GO );
-    tinygl_clear ();
-
-    while ( attemptCount < numberOfDirections ) {
-        pacer_wait ();
-        navswitch_update ();
-        tinygl_update ();
-
-        if ( navswitch_push_event_p ( NAVSWITCH_NORTH ) ) {
-            repeatAttempt = NORTH;
-            attemptEvaluation ( &repeatAttempt, &attemptCount );
-        } else if ( navswitch_push_event_p ( NAVSWITCH_SOUTH ) ) {
-            repeatAttempt = SOUTH;
-            attemptEvaluation ( &repeatAttempt, &attemptCount );
-        } else if ( navswitch_push_event_p ( NAVSWITCH_EAST ) ) {
-            repeatAttempt = EAST;
-            attemptEvaluation ( &repeatAttempt, &attemptCount );
-        } else if ( navswitch_push_event_p ( NAVSWITCH_WEST ) ) {
-            repeatAttempt = WEST;
-            attemptEvaluation ( &repeatAttempt, &attemptCount );
-        }
+ * Update for states that scroll their message until the navswitch is
+ * pushed. This is used for when the game is awaiting upon a player's
+ * activation for continuation.
+ */
+uint8_t awaitPush ( game_t *game ) {
+    state_t row;
 
-        if (navswitch_push_event_p ( NAVSWITCH_PUSH ) ) {
-            repeatAttempt = RESIGN;
-            attemptCount = numberOfDirections;
-        }
-        displayChar ( &repeatAttempt );
+    if ( scrollPushed ( game ) ) {
+        stateRow ( game->state, &row );
+        return row.next;
     }
-    timerDelay ( &repeatAttempt, &pause );
+    return game->state;
 }
 
 /**
- * Loops until the nav button has been pushed. This is used for when
- * the game is awaiting upon a player's activation for continuation.
+ * Returns the state a tournament board plays a match in: player SENDER
+ * or RECEIVER if it is one of the match's pair, or otherwise waiting
+ * quietly for the next match, acknowledging nothing. Frames of the last
+ * match still awaiting acknowledgement are abandoned, as their board
+ * may now be waiting.
  */
-void navPushUpdate ( void ) {
-    bool navPush = false;
+uint8_t matchState ( game_t *game, uint8_t match ) {
+    uint8_t sender, receiver;
+
+    game->match = match;
+    game->announcing = false;
+    linkReset ( &game->link );
+    tournamentPair ( game->nodes, match, &sender, &receiver );
+
+    if ( game->node == sender ) {
+        return STATE_SENDER_LEVEL_PROMPT;
+    } else if ( game->node == receiver ) {
+        return STATE_RECEIVER_PARAMETERS;
+    }
+    linkListen ( &game->link );
+    return STATE_TOURNAMENT_WAIT;
+}
 
-    while ( !navPush ) {
-        pacer_wait ();
-        navswitch_update ();
-        tinygl_update ();
+/**
+ * Returns the state a tournament match's SENDER waits for the next match
+ * in once told this one is over, listening like every board not in it
+ */
+uint8_t matchOver ( game_t *game ) {
+    linkListen ( &game->link );
+    return STATE_TOURNAMENT_WAIT;
+}
 
-        if ( navswitch_push_event_p ( NAVSWITCH_PUSH ) ) {
-            navPush = true;
-        }
+/**
+ * Starts a tournament match on every board, returning the state this
+ * board plays it in. The start is announced again until it is heard
+ * played, in case every copy was lost.
+ */
+uint8_t matchBegin ( game_t *game, uint8_t match ) {
+    uint8_t state;
+
+    tournamentSend ( &game->ir, game->node, match, TOURNAMENT_REPEATS );
+    state = matchState ( game, match );
+    game->announcing = true;
+    deadlineSet ( &game->tick, &game->announceDeadline, TOURNAMENT_ANNOUNCE_PERIOD );
+    return state;
+}
+
+/**
+ * Announces the start of the match this board began again every
+ * TOURNAMENT_ANNOUNCE_PERIOD until an acknowledgement is heard, which
+ * only a board of the match's pair sends, to a frame of the other
+ */
+void matchAnnounce ( game_t *game ) {
+    if ( linkHeard ( &game->link ) ) {
+        game->announcing = false;
+    } else if ( deadlineExpired ( &game->tick, &game->announceDeadline ) ) {
+        tournamentSend ( &game->ir, game->node, game->match, 1 );
+        deadlineSet ( &game->tick, &game->announceDeadline, TOURNAMENT_ANNOUNCE_PERIOD );
     }
 }
 
 /**
- * Player SENDER chooses the level of difficulty of the game from 1 to 3;
- * easiest to hardest. The level of difficulty determines temporal
- * speed of which the directions are displayed to player RECEIVER board.
- */
-void chooseGameDifficulty ( void ) {
-    bool pushed = false;
-    difficulty = LVL_ONE;
-
-    while ( !pushed ) {
-        pacer_wait ();
-        tinygl_update ();
-        navswitch_update ();
-
-        if ( navswitch_push_event_p ( NAVSWITCH_EAST ) ) {
-            if ( difficulty < LVL_THREE ) {
-                difficulty++;
-            }
-        } else if ( navswitch_push_event_p ( NAVSWITCH_NORTH ) ) {
-            if ( difficulty < LVL_THREE ) {
-                difficulty++;
-            }
-        } else if ( navswitch_push_event_p ( NAVSWITCH_SOUTH ) ) {
-            if ( difficulty > LVL_ONE ) {
-                difficulty--;
-            }
-        } else if ( navswitch_push_event_p ( NAVSWITCH_WEST ) ) {
-            if ( difficulty > LVL_ONE ) {
-                difficulty--;
-            }
-        } else if ( navswitch_push_event_p ( NAVSWITCH_PUSH ) ) {
-            pushed = true;
-        }
-        displayChar ( &difficulty );
+ * Returns the tournament match after the one last played, starting the
+ * round again after its last match
+ */
+uint8_t matchNext ( game_t *game ) {
+    return ( game->match + 1 ) % tournamentRound ( game->nodes );
+}
+
+/**
+ * Takes the frame delivered this tick if it starts a tournament match
+ * other than the one being played, or any match before the first is,
+ * returning false if it does not or the match is not one of the round.
+ * Any other frame is left for the state.
+ */
+bool matchStarted ( game_t *game, uint8_t *match ) {
+    const frame_t *frame = linkPeek ( &game->link );
+
+    if ( !frame || !tournamentReceive ( frame, match ) || ( *match >= tournamentRound ( game->nodes ) )
+            || ( ( *match == game->match ) && ( game->state != STATE_START ) ) ) {
+        return false;
     }
-    convertDifficultyToInt ();
+    linkReceive ( &game->link );
+    return true;
 }
 
 /**
- * Starts the game when navswitch button on either board is pushed.
- * Board that navswitch button is pressed becomes player SENDER and
- * a message "R" is transmitted to the other board for declaration
+ * Flashes the LED while "START GAME" scrolls, at game start
  */
-void gameStart ( char *player, int loopRate ) {
-    bool gameStart = false;
-    int flasher = 0;
-    char receptionChar;
-    displayString ( GAME_START );
+void enterGameStart ( game_t *game ) {
     pio_config_set ( LED1_PIO, PIO_OUTPUT_HIGH );
+    deadlineSet ( &game->tick, &game->displayDeadline, LED_FLASH );
+}
 
-    while ( !gameStart ) {
-        pacer_wait ();
-        navswitch_update ();
-        tinygl_update ();
-        flasher++;
+/**
+ * Starts the game when navswitch button on either board is pushed.
+ * Board that navswitch button is pressed becomes player SENDER and
+ * a message "R" is transmitted to the other board for declaration.
+ * In a tournament the board pushed starts the first match instead.
+ */
+uint8_t gameStart ( game_t *game ) {
+    if ( deadlineExpired ( &game->tick, &game->displayDeadline ) ) {
+        pio_output_toggle ( LED1_PIO );
+        deadlineSet ( &game->tick, &game->displayDeadline, LED_FLASH );
+    }
 
-        if ( flasher > loopRate / 2 ) {
-            flasher = 0;
-            pio_output_toggle ( LED1_PIO );
-        }
+    if ( scrollPushed ( game ) ) {
+        led_set ( LED1, 0 );
 
-        if ( navswitch_push_event_p ( NAVSWITCH_PUSH ) ) {
-            gameStart = true;
-            *player = SENDER;
-            setStaticDisplay ();
-            ir_uart_putc ( RECEIVER );
-        } else if ( ir_uart_read_ready_p () ) {
-            receptionChar = ir_uart_getc ();
-
-            if ( receptionChar == RECEIVER ) {
-                gameStart = true;
-                *player = RECEIVER;
-                setStaticDisplay ();
-                displayChar ( &receptionChar );
-            }
+        if ( game->nodes ) {
+            return matchBegin ( game, 0 );
         }
+        linkPutc ( &game->link, RECEIVER );
+        return STATE_SENDER_LEVEL_PROMPT;
+    } else if ( !game->nodes && ( linkMessage ( linkReceive ( &game->link ) ) == RECEIVER ) ) {
+        led_set ( LED1, 0 );
+        return STATE_RECEIVER_PARAMETERS;
     }
-    led_set ( LED1, 0 );
+    return game->state;
 }
 
 /**
- *  Player RECEIVER receives the game difficulty chosen by player SENDER,
- * 	as a char and sets the difficulty to determine the temporal rate
- *  for the display of each recepted direction from teh SENDER board.
- * 	A confirmation package is transmitted back to the SENDER board.
+ * Player SENDER starts choosing the game game->difficulty from level one
  */
-void setGameParameters ( bool *confirmation ) {
-    if ( ir_uart_read_ready_p () ) {
-        difficulty = ir_uart_getc ();
+void enterLevelPrompt ( game_t *game ) {
+    led_set ( LED1, 1 );
+    levelSet ( game, LVL_ONE );
+}
 
-        if ( ( difficulty == LVL_ONE ) || ( difficulty == LVL_TWO ) || ( difficulty == LVL_THREE ) ) {
-            convertDifficultyToInt ();
-            activityComplete = false;
-            *confirmation = true;
-            ir_uart_putc ( CHANGE_PLAY );
-        }
-    }
+/**
+ * Player SENDER's game->difficulty choice starts at the easiest
+ */
+void enterGameDifficulty ( game_t *game ) {
+    game->difficulty = LVL_ONE;
 }
 
 /**
- * Displays a count down from 3 to 1 before directions are displayed.
+ * Player SENDER chooses the level of game->difficulty of the game from 1 to 3;
+ * easiest to hardest. The level of game->difficulty determines temporal
+ * speed of which the game->directions are displayed to player RECEIVER board.
+ * The choice is transmitted to player RECEIVER once the navswitch is pushed.
  */
-void countDown ( void ) {
-    char counter = LVL_THREE;
-    int maxTime = PAUSE;
+uint8_t chooseGameDifficulty ( game_t *game ) {
+    char choice = navDirection ( game );
 
-    while ( counter >= LVL_ONE ) {
-        displayChar ( &counter );
-        timerDelay ( &counter, &maxTime );
-        counter--;
+    if ( ( choice == NORTH ) || ( choice == EAST ) ) {
+        if ( game->difficulty < DIFFICULTY_LAST ) {
+            game->difficulty++;
+        }
+    } else if ( ( choice == SOUTH ) || ( choice == WEST ) ) {
+        if ( game->difficulty > LVL_ONE ) {
+            game->difficulty--;
+        }
+    } else if ( navPushed ( game, NAVSWITCH_PUSH ) ) {
+        difficultyLoad ( game );
+        displayClear ( &game->disp );
+        linkPutc ( &game->link, game->difficulty );
+        return STATE_SENDER_CONFIRM;
     }
+    displayChar ( &game->disp, &game->difficulty );
+    return game->state;
 }
 
 /**
- * Displays all of the directions transmitted to the RECEIVER board after
- * each transmission of directions has been successfully completed.
+ * SENDER player awaits a confirmation from RECEIVER of the game game->difficulty
  */
-void directionDisplay ( void ) {
-    int pause = displaySpeed;
-
-    while ( directionsTransmitted < numberOfDirections ) {
-        displayChar ( &directionsArray[ directionsTransmitted ] );
-        timerDelay ( &directionsArray[ directionsTransmitted ], &pause );
-        directionsTransmitted++;
-        //timer_wait ( ( timer_tick_t ) ( TIMER_RATE * .03 ) );
+uint8_t senderParameterSetting ( game_t *game ) {
+    if ( linkMessage ( linkReceive ( &game->link ) ) == CHANGE_PLAY ) {
+        return STATE_SENDER_DIRECTIONS;
     }
-    display_clear ();
-    directionsTransmitted = 0;
+    return game->state;
 }
 
 /**
- * Reception of infra-red transmitted data packages from SENDER board.
- * For every data package recepted that contains either a N, S, E, or W
- * char, an equal data package is transmitted back to the SENDER board
- * for confirmation of each direction transmitions success.
+ * Player SENDER starts entering the game->directions for the current level
  */
-void directionReception ( bool *transmitted ) {
-    if ( directionsTransmitted < numberOfDirections ) {
-        if ( ir_uart_read_ready_p () ) {
-            direction = ir_uart_getc ();
+void enterSendingDirections ( game_t *game ) {
+    led_set ( LED1, 1 );
+    game->inputCount = 0;
+    levelLoad ( game );
+    game->charInput = FLASH_READ_BYTE ( &levelTable[ game->gameLevel - LVL_ONE ].glyph );
+}
 
-            if ( ( direction == NORTH ) || ( direction == SOUTH ) || ( direction == EAST ) || ( direction == WEST ) ) {
-                directionsArray[ directionsTransmitted ] = direction;
-                directionsTransmitted++;
-                ir_uart_putc ( direction );
-            }
-        }
+/**
+ * The SENDER player enters the game->directions to be sent to the RECEIVER
+ * player by moving the navswitch in any direction until the total
+ * number of game->directions to be played have been chosen.
+ * So long as not all game->directions permitted are given, player SENDER can
+ * reset the input of game->directions by pressing the navswitch button down.
+ */
+uint8_t chooseSendingDirections ( game_t *game ) {
+    char choice = navDirection ( game );
+
+    if ( choice ) {
+        game->charInput = choice;
+        directionsSet ( &game->directions, game->inputCount, choice );
+        game->inputCount++;
+    } else if ( navPushed ( game, NAVSWITCH_PUSH ) ) {
+        game->charInput = RESET;
+        game->inputCount = 0;
     }
+    displayChar ( &game->disp, &game->charInput );
 
-    if ( directionsTransmitted == numberOfDirections ) {
-        *transmitted = false;
-        directionsTransmitted = 0;
+    if ( game->inputCount == game->numberOfDirections ) {
+        return STATE_SENDER_TRANSMIT;
     }
+    return game->state;
 }
 
 /**
- * Data packages containing chars representative of chosen directions
- * are infra-red transmitted from the SENDER board to the RECEIVER board.
- * Waits for confirmation of each data package transmission before
- * continuing to transmit the next until all directions transmitted.
+ * All of the chosen game->directions are infra-red transmitted from the
+ * SENDER board to the RECEIVER board in a single frame, as one burst.
+ * The frame holds the number of game->directions then the packed game->directions.
  */
-void transmitDirections ( bool *transmitted ) {
-    if ( ( directionsTransmitted > 0 ) && ( !recepted ) ) {
-        if ( ir_uart_read_ready_p () ) {
-            char confirmationChar = ir_uart_getc ();
+void enterTransmitDirections ( game_t *game ) {
+    uint8_t payload[ FRAME_PAYLOAD_MAX ];
+    uint8_t length = DIRECTIONS_BYTES ( game->numberOfDirections );
+
+    payload[ 0 ] = game->numberOfDirections;
+    memcpy ( &payload[ 1 ], game->directions.bits, length );
+    linkSend ( &game->link, FRAME_DIRECTIONS, payload, length + 1 );
+    displayConst ( &game->disp, SENDER );
+}
 
-            if ( confirmationChar  == directionsArray[ directionsTransmitted - 1 ] ) {
-                recepted = true;
-            }
-        }
+/**
+ * Waits for the RECEIVER board to acknowledge the frame of game->directions
+ */
+uint8_t transmitDirections ( game_t *game ) {
+    if ( linkIdle ( &game->link ) ) {
+        return STATE_SENDER_OUTCOME;
     }
+    return game->state;
+}
 
-    if ( ( directionsTransmitted < numberOfDirections ) && ( recepted ) ) {
-        ir_uart_putc ( directionsArray[ directionsTransmitted ] );
-        directionsTransmitted++;
-        recepted = false;
+/**
+ * Player SENDER is locked down while player RECEIVER plays
+ */
+void enterSenderOutcome ( game_t *game ) {
+    ( void ) game;
+    led_set ( LED1, 0 );
+}
+
+/**
+ * Player SENDER awaits transmission from player RECEIVER of game play
+ * outcome; either the next level to send game->directions for, or a swap of
+ * player roles once player RECEIVER has failed or won the game. The
+ * frame of player RECEIVER's reaction times for the level comes first.
+ * In a tournament the swap is instead the end of the match, and player
+ * SENDER listens for the frame starting the next one.
+ */
+uint8_t senderGamePlay ( game_t *game ) {
+    const frame_t *frame = linkReceive ( &game->link );
+    char reception = linkMessage ( frame );
+
+    if ( !frame ) {
+        return game->state;
+    } else if ( ( reception > LVL_ONE ) && ( reception <= LVL_LAST ) ) {
+        levelSet ( game, reception );
+        return STATE_SENDER_DIRECTIONS;
+    } else if ( reception == RECEIVER ) {
+        return game->nodes ? matchOver ( game ) : STATE_RECEIVER_PARAMETERS;
+    } else if ( !reactReceive ( frame, &game->peerReactions ) ) {
+        linkUnexpected ( &game->link );
     }
+    return game->state;
+}
 
-    if ( directionsTransmitted == numberOfDirections && ( !recepted ) ) {
-        *transmitted = true;
-        recepted = true;
-        directionsTransmitted = 0;
+/**
+ * Player RECEIVER is locked down until player SENDER chooses a game->difficulty
+ */
+void enterGameParameters ( game_t *game ) {
+    led_set ( LED1, 0 );
+    levelSet ( game, LVL_ONE );
+    displayConst ( &game->disp, RECEIVER );
+}
+
+/**
+ *  Player RECEIVER receives the game game->difficulty chosen by player SENDER,
+ * 	as a char and sets the game->difficulty to determine the temporal rate
+ *  for the display of each recepted direction from the SENDER board.
+ * 	A confirmation package is transmitted back to the SENDER board.
+ */
+uint8_t setGameParameters ( game_t *game ) {
+    const frame_t *frame = linkReceive ( &game->link );
+    char reception = linkMessage ( frame );
+
+    if ( ( reception >= LVL_ONE ) && ( reception <= DIFFICULTY_LAST ) ) {
+        game->difficulty = reception;
+        difficultyLoad ( game );
+        linkPutc ( &game->link, CHANGE_PLAY );
+        return STATE_RECEIVER_DIRECTIONS;
+    } else if ( frame ) {
+        linkUnexpected ( &game->link );
     }
+    return game->state;
 }
 
 /**
- * Sets booleans to false for the next level of game play,
- * or for game restart.
+ * Player RECEIVER is locked down while game->directions are received
  */
-void endOfSenderPlay ( bool *transmitted ) {
-    parametersConfirmed = false;
-    activityComplete = false;
-    *transmitted = false;
+void enterDirectionReception ( game_t *game ) {
+    led_set ( LED1, 0 );
+    displayConst ( &game->disp, RECEIVER );
+    levelLoad ( game );
 }
 
 /**
- * SENDER player chooses game difficulty at game start and transmits
- * the choice to RECEIVER player, then awaits a confirmation from RECEIVER.
- * Othwerwise, if game started, awaits a transmition of level increase
+ * Reception of the infra-red transmitted frame of game->directions from SENDER
+ * board. Taking the frame holding the number of game->directions for the level
+ * acknowledges it to the SENDER board for confirmation.
  */
-void senderParameterSetting ( bool *transmitted ) {
-    if ( !*transmitted ) {
-        led_set ( LED1, 1 );
+uint8_t directionReception ( game_t *game ) {
+    const frame_t *frame = linkReceive ( &game->link );
+    uint8_t length = DIRECTIONS_BYTES ( game->numberOfDirections );
 
-        if ( ( !activityComplete ) && ( gameLevel == LVL_ONE ) ) {
-            continuousScroll ( LVL_CHOOSE );
-            chooseGameDifficulty ();
-            tinygl_clear ();
-            ir_uart_putc ( difficulty );
-            activityComplete = true;
-        }
+    if ( !frame || ( frame->type != FRAME_DIRECTIONS ) || ( frame->length != length + 1 ) || ( frame->payload[ 0 ] != game->numberOfDirections ) ) {
+        return game->state;
     }
+    memcpy ( game->directions.bits, &frame->payload[ 1 ], length );
+    return STATE_RECEIVER_PROMPT;
+}
 
-    if ( ir_uart_read_ready_p () ) {
-        char reception = ir_uart_getc ();
+/**
+ * Player RECEIVER is prompted to start playing the recepted game->directions
+ */
+void enterReceiverPrompt ( game_t *game ) {
+    ( void ) game;
+    led_set ( LED1, 1 );
+}
 
-        if ( reception == CHANGE_PLAY ) {
-            *transmitted = true;
-            gameLevel = LVL_ONE;
-        }
-    } else if ( gameLevel > LVL_ONE ) {
-        *transmitted = true;
-        activityComplete = true;
+/**
+ * Starts the count down from 3 to 1 before game->directions are displayed
+ */
+void enterCountDown ( game_t *game ) {
+    game->counter = LVL_THREE;
+    deadlineSet ( &game->tick, &game->displayDeadline, PAUSE );
+}
+
+/**
+ * Displays a count down from 3 to 1 before game->directions are displayed,
+ * one step per tick. Each number is shown for PAUSE milliseconds.
+ */
+uint8_t countDown ( game_t *game ) {
+    displayChar ( &game->disp, &game->counter );
+
+    if ( deadlineExpired ( &game->tick, &game->displayDeadline ) ) {
+        game->counter--;
+        deadlineSet ( &game->tick, &game->displayDeadline, PAUSE );
     }
 
-    if ( *transmitted ) {
-        parametersConfirmed = true;
-        activityComplete = false;
-        *transmitted = false;
+    if ( game->counter < LVL_ONE ) {
+        return STATE_RECEIVER_DISPLAY;
     }
+    return game->state;
 }
 
 /**
- * Player SENDER sends chosen directions to player RECEIVER then
- * awaits transmission from player RECEIVER of game play outcome
+ * Starts displaying the recepted game->directions from the first
  */
-void senderGamePlay ( bool *transmitted, char *play ) {
-    if ( !*transmitted ) {
-        if ( !activityComplete ) {
-            chooseSendingDirections ();
-            activityComplete = true;
-        }
-        transmitDirections ( transmitted );
-        displayConst ( SENDER );
-    }
+void enterDirectionDisplay ( game_t *game ) {
+    game->directionsDisplayed = 0;
+    deadlineSet ( &game->tick, &game->displayDeadline, game->displayTime );
+}
 
-    if ( *transmitted ) {
-        led_set ( LED1, 0 );
+/**
+ * Displays all of the game->directions transmitted to the RECEIVER board after
+ * each transmission of game->directions has been successfully completed, one
+ * step per tick. Each direction is shown for game->displayTime milliseconds.
+ */
+uint8_t directionDisplay ( game_t *game ) {
+    char shown = directionsGet ( &game->directions, game->directionsDisplayed );
+    displayChar ( &game->disp, &shown );
 
-        if ( ir_uart_read_ready_p () ) {
-            char reception = ir_uart_getc ();
-
-            if ( reception == CHANGE_PLAY ) {
-                endOfSenderPlay ( transmitted );
-            } else if ( ( reception == LVL_TWO ) || ( reception == LVL_THREE ) ) {
-                endOfSenderPlay ( transmitted );
-                gameLevel = reception;
-            } else if ( reception == RECEIVER )
-            {
-                *play = RECEIVER;
-                displayConst ( RECEIVER );
-                gameLevel = LVL_ONE;
-                endOfSenderPlay ( transmitted );
-            }
-        }
+    if ( deadlineExpired ( &game->tick, &game->displayDeadline ) ) {
+        game->directionsDisplayed++;
+        deadlineSet ( &game->tick, &game->displayDeadline, game->displayTime );
     }
+
+    if ( game->directionsDisplayed == game->numberOfDirections ) {
+        displayClear ( &game->disp );
+        game->directionsDisplayed = 0;
+        game->reactFrom = inputMillis ( &game->input );
+        return STATE_RECEIVER_GO;
+    }
+    return game->state;
 }
 
 /**
- * Player SENDER game play schematics
+ * Player RECEIVER starts repeating game->directions with a game->score of nothing
  */
-void playerTurnSender ( bool *transmitted, char *play ) {
-    if ( !parametersConfirmed ) {
-         senderParameterSetting ( transmitted );
-    }
+void enterRepeatDirections ( game_t *game ) {
+    game->attemptCount = 0;
+    game->score = 0;
+    game->repeatAttempt = '*';
+}
 
-    if ( parametersConfirmed ) {
-        senderGamePlay (transmitted, play);
+/**
+ * Checks if each attempt made at repeating direction by RECEIVER player
+ * is a correct choice, and increments game->score if so, and attempt count.
+ * The time taken to make the attempt, from the last attempt or from the
+ * end of the directions' display for the first, is added to the level's
+ * reaction times.
+ */
+void attemptEvaluation ( game_t *game, char *attempt ) {
+    displayChar ( &game->disp, attempt );
+    reactRecord ( &game->reactions, game->gameLevel - LVL_ONE, game->difficulty - LVL_ONE,
+                  game->event.time - game->reactFrom );
+    game->reactFrom = game->event.time;
+
+    if ( directionsGet ( &game->directions, game->attemptCount ) == *attempt ) {
+        game->score++;
     }
+    game->attemptCount++;
 }
 
 /**
- * Player RECEIVER receives transmitted directions, displays them at
- * a temporal rate dependent on game difficulty, and then attempts
- * to repeat them in the same order as displayed for score points.
+ * Player RECEIVER attempts to repeat game->directions given by player SENDER.
+ * A game->score count is implemented for each successful direction repeated
+ * by player RECEIVER. Pushing the navswitch resigns the attempt.
  */
-void receiverGamePlay ( bool *transmitted ) {
-    if ( *transmitted ) {
-        convertGameLeveltoInt ();
-        directionReception ( transmitted );
+uint8_t repeatDirections ( game_t *game ) {
+    char attempt = navDirection ( game );
+
+    if ( attempt ) {
+        game->repeatAttempt = attempt;
+        attemptEvaluation ( game, &game->repeatAttempt );
+    } else if ( navPushed ( game, NAVSWITCH_PUSH ) ) {
+        game->repeatAttempt = RESIGN;
+        game->attemptCount = game->numberOfDirections;
     }
+    displayChar ( &game->disp, &game->repeatAttempt );
 
-    if ( !*transmitted ) {
-        tinygl_clear ();
-        led_set ( LED1, 1 );
-        continuousScroll ( RECEIVER_START );
-        countDown ();
-        directionDisplay ();
-        repeatDirections ();
-        activityComplete = true;
+    if ( game->attemptCount == game->numberOfDirections ) {
+        return STATE_RECEIVER_RESULT;
     }
+    return game->state;
+}
+
+/**
+ * The last attempt is shown for a pause once all attempts are made
+ */
+void enterPlayOutcome ( game_t *game ) {
+    deadlineSet ( &game->tick, &game->displayDeadline, PAUSE );
 }
 
 /**
  * Score points from player RECEIVER's game play are compared to
- * the number of directions played. If equal, then RECEIVER wins
+ * the number of game->directions played. If equal, then RECEIVER wins
  * level. If RECEIVER wins three consecutive levels, wins game.
  * The status of game play continuation is determined here
  * dependent on whether RECEIVER player wins, or loses levels, or
- * wins the game.
- *
- */
-void receiverPlayOutcome ( bool *gameWon, bool *transmitted, char *play ) {
-    if ( score == numberOfDirections ) {
-        allDirectionsRepeated = true;
-    }
-    score = 0;
-
-    if ( allDirectionsRepeated ) {
-        allDirectionsRepeated = false;
-
-        if ( gameLevel == LVL_THREE ) {
-            *gameWon = true;
-            gameLevel = LVL_ONE;
-        } else if ( gameLevel < LVL_THREE ) {
-            activityComplete = false;
-            *transmitted = true;
-            continuousScroll ( LEVEL_WON );
-            tinygl_clear ();
-            gameLevel++;
-            ir_uart_putc ( gameLevel );
-            displayConst ( RECEIVER );
-            led_set ( LED1, 0 );
+ * wins the game. Either way the level's reaction times are sent to
+ * player SENDER, followed in a tournament by the match being over if
+ * the level is failed.
+ */
+uint8_t receiverPlayOutcome ( game_t *game ) {
+    displayChar ( &game->disp, &game->repeatAttempt );
+
+    if ( !deadlineExpired ( &game->tick, &game->displayDeadline ) ) {
+        return game->state;
+    }
+    reactSend ( &game->link, &game->reactions, game->gameLevel - LVL_ONE, game->difficulty - LVL_ONE );
+
+    if ( game->score != game->numberOfDirections ) {
+        if ( game->nodes ) {
+            linkPutc ( &game->link, RECEIVER );
         }
-        activityComplete = false;
-    } else {
-        continuousScroll ( GAME_FAIL );
-        tinygl_clear ();
-        gameLevel = LVL_ONE;
-        *play = SENDER;
-        endOfSenderPlay ( transmitted );
-        ir_uart_putc ( RECEIVER );
+        return STATE_RECEIVER_FAILED;
+    } else if ( game->gameLevel == LVL_LAST ) {
+        return STATE_RECEIVER_GAME_WON;
     }
+    return STATE_RECEIVER_LEVEL_WON;
 }
 
 /**
- * Player RECEIVER game play schematics
+ * Once player RECEIVER acknowledges winning the level, the next
+ * level is transmitted to player SENDER
  */
-void playerTurnReceiver ( bool *gameWon, bool *transmitted, char *play ) {
-    if ( !activityComplete ) {
-        receiverGamePlay ( transmitted );
+uint8_t levelWon ( game_t *game ) {
+    if ( scrollPushed ( game ) ) {
+        levelSet ( game, game->gameLevel + 1 );
+        linkPutc ( &game->link, game->gameLevel );
+        return STATE_RECEIVER_DIRECTIONS;
     }
+    return game->state;
+}
 
-    if ( activityComplete ) {
-        receiverPlayOutcome ( gameWon, transmitted, play );
+/**
+ * Once player RECEIVER acknowledges failing the level, the player
+ * roles swap and play restarts from level one, or in a tournament the
+ * next match starts, once player SENDER has acknowledged the match over
+ */
+uint8_t levelFailed ( game_t *game ) {
+    if ( game->nodes ) {
+        return linkIdle ( &game->link ) && scrollPushed ( game ) ? matchBegin ( game, matchNext ( game ) ) : game->state;
+    } else if ( scrollPushed ( game ) ) {
+        linkPutc ( &game->link, RECEIVER );
+        return STATE_SENDER_LEVEL_PROMPT;
     }
+    return game->state;
 }
 
 /**
  * Declares that the winning player has won by displaying "GAME WON!"
- * on the winning player's LED and resets the game for a new gameLevel.
- * For this new gameLevel, the player roles swap. The player playing the
+ * on the winning player's LED and resets the game for a new game->gameLevel.
+ * For this new game->gameLevel, the player roles swap. The player playing the
  * role of RECEIVER starts playing the role of SENDER, and vice-versa.
+ * In a tournament the same message tells player SENDER the match is over,
+ * and the next match starts once the win is acknowledged.
+ */
+void gameWin ( game_t *game ) {
+    levelSet ( game, LVL_ONE );
+    linkPutc ( &game->link, RECEIVER );
+}
+
+/**
+ * Once the winning player acknowledges winning, plays on as player
+ * SENDER, or in a tournament starts the next match, once player SENDER
+ * has acknowledged the match over
+ */
+uint8_t gameWon ( game_t *game ) {
+    if ( game->nodes ) {
+        return linkIdle ( &game->link ) && scrollPushed ( game ) ? matchBegin ( game, matchNext ( game ) ) : game->state;
+    }
+    return awaitPush ( game );
+}
+
+/**
+ * A tournament board not in the match shows its node, from 1, with
+ * its LED off, and transmits nothing but announcements of the match if
+ * it began it, not even acknowledgements
+ */
+void enterTournamentWait ( game_t *game ) {
+    led_set ( LED1, 0 );
+    game->charInput = '1' + game->node;
+    displayChar ( &game->disp, &game->charInput );
+}
+
+/**
+ * A tournament board not in the match only listens, for the frame
+ * starting the next match, which playTick () takes, discarding all else
+ */
+uint8_t tournamentWait ( game_t *game ) {
+    linkReceive ( &game->link );
+    return game->state;
+}
+
+const state_t stateTable[ STATE_COUNT ] PROGMEM = {
+    [ STATE_START ] = { GAME_START, STATE_START, enterGameStart, gameStart },
+    [ STATE_SENDER_LEVEL_PROMPT ] = { LVL_CHOOSE, STATE_SENDER_DIFFICULTY, enterLevelPrompt, awaitPush },
+    [ STATE_SENDER_DIFFICULTY ] = { 0, STATE_SENDER_DIFFICULTY, enterGameDifficulty, chooseGameDifficulty },
+    [ STATE_SENDER_CONFIRM ] = { 0, STATE_SENDER_CONFIRM, 0, senderParameterSetting },
+    [ STATE_SENDER_DIRECTIONS ] = { 0, STATE_SENDER_DIRECTIONS, enterSendingDirections, chooseSendingDirections },
+    [ STATE_SENDER_TRANSMIT ] = { 0, STATE_SENDER_TRANSMIT, enterTransmitDirections, transmitDirections },
+    [ STATE_SENDER_OUTCOME ] = { 0, STATE_SENDER_OUTCOME, enterSenderOutcome, senderGamePlay },
+    [ STATE_RECEIVER_PARAMETERS ] = { 0, STATE_RECEIVER_PARAMETERS, enterGameParameters, setGameParameters },
+    [ STATE_RECEIVER_DIRECTIONS ] = { 0, STATE_RECEIVER_DIRECTIONS, enterDirectionReception, directionReception },
+    [ STATE_RECEIVER_PROMPT ] = { RECEIVER_START, STATE_RECEIVER_COUNTDOWN, enterReceiverPrompt, awaitPush },
+    [ STATE_RECEIVER_COUNTDOWN ] = { 0, STATE_RECEIVER_COUNTDOWN, enterCountDown, countDown },
+    [ STATE_RECEIVER_DISPLAY ] = { 0, STATE_RECEIVER_DISPLAY, enterDirectionDisplay, directionDisplay },
+    [ STATE_RECEIVER_GO ] = { GO, STATE_RECEIVER_REPEAT, 0, awaitPush },
+    [ STATE_RECEIVER_REPEAT ] = { 0, STATE_RECEIVER_REPEAT, enterRepeatDirections, repeatDirections },
+    [ STATE_RECEIVER_RESULT ] = { 0, STATE_RECEIVER_RESULT, enterPlayOutcome, receiverPlayOutcome },
+    [ STATE_RECEIVER_LEVEL_WON ] = { LEVEL_WON, STATE_RECEIVER_LEVEL_WON, 0, levelWon },
+    [ STATE_RECEIVER_FAILED ] = { GAME_FAIL, STATE_RECEIVER_FAILED, 0, levelFailed },
+    [ STATE_RECEIVER_GAME_WON ] = { GAME_WIN, STATE_SENDER_LEVEL_PROMPT, gameWin, gameWon },
+    [ STATE_TOURNAMENT_WAIT ] = { 0, STATE_TOURNAMENT_WAIT, enterTournamentWait, tournamentWait }
+};
+
+/**
+ * Moves the game into a state, scrolling its message and running its entry action
+ */
+void stateEnter ( game_t *game, uint8_t newState ) {
+    state_t row;
+
+    game->state = newState;
+    TRACE_EVENT ( TRACE_STATE, newState );
+    stateRow ( newState, &row );
+
+    if ( row.message ) {
+        continuousScroll ( &game->disp, row.message );
+    }
+
+    if ( row.enter ) {
+        row.enter ( game );
+    }
+}
+
+/**
+ * Starts the game at the "START GAME" scroll
+ */
+void playInit ( game_t *game ) {
+    game->node = 0;
+    game->nodes = 0;
+    game->match = 0;
+    game->announcing = false;
+    reactInit ( &game->reactions );
+    game->peerReactions.times.count = 0;
+    linkInit ( &game->link, &game->ir, &game->tick );
+    stateEnter ( game, STATE_START );
+}
+
+/**
+ * Puts the game into a tournament of a number of boards as a node from 0
+ */
+void playTournament ( game_t *game, uint8_t node, uint8_t nodes ) {
+    game->node = node;
+    game->nodes = nodes;
+}
+
+/**
+ * Runs one pacer tick of game play for whichever player this board is,
+ * taking at most one queued navswitch press and one delivered frame for
+ * it to act on. In a tournament a frame starting another match is acted
+ * on whatever the state, as a board that missed the end of its last
+ * match may be in any.
+ */
+void playTick ( game_t *game ) {
+    PROF_BEGIN ( start );
+    uint8_t state = game->state;
+    uint8_t newState, match;
+    state_t row;
+
+    if ( inputGet ( &game->input, &game->event ) ) {
+        TRACE_EVENT ( TRACE_NAV, game->event.navswitch );
+    } else {
+        game->event.navswitch = INPUT_NONE;
+    }
+    linkUpdate ( &game->link );
+
+    if ( game->announcing ) {
+        matchAnnounce ( game );
+    }
+
+    if ( game->nodes && matchStarted ( game, &match ) ) {
+        newState = matchState ( game, match );
+    } else {
+        stateRow ( state, &row );
+        newState = row.update ( game );
+    }
+
+    PROF_END ( start, PROF_STATE + state );
+
+    if ( newState != game->state ) {
+        stateEnter ( game, newState );
+    }
+}
+
+/**
+ * Returns true while the game only scrolls a message awaiting a push.
+ * These are the states with a message in stateTable; a push is queued
+ * with its time by the sampling interrupt whatever the pacer rate.
  */
-void gameWin ( bool *gameWon, char *play ) {
-    *gameWon = false;
-    *play = SENDER;
-    ir_uart_putc ( RECEIVER );
-    continuousScroll ( GAME_WIN );
+bool playIdle ( const game_t *game ) {
+    state_t row;
+
+    stateRow ( game->state, &row );
+    return row.message != 0;
+}
+
+#ifdef RECORD
+/**
+ * Adds bytes to an FNV-1a digest
+ */
+static uint32_t digestAdd ( uint32_t digest, const void *bytes, size_t length ) {
+    const uint8_t *byte = bytes;
+
+    while ( length-- ) {
+        digest = ( digest ^ *byte++ ) * 16777619UL;
+    }
+    return digest;
+}
+
+/**
+ * Returns a digest of the game play, for a replay of its log to be
+ * checked against. Fields are added one by one, as integers, so no
+ * padding or pointer is added.
+ */
+uint32_t playDigest ( const game_t *game ) {
+    const link_t *link = &game->link;
+    const link_stats_t *stats = linkStats ( link );
+    const frame_t *frame;
+    const react_t *cell;
+    int32_t play[] = { game->state, game->node, game->nodes, game->match, game->difficulty, game->gameLevel,
+                       game->counter, game->charInput, game->repeatAttempt, game->score, game->directionsDisplayed,
+                       game->numberOfDirections, game->displayTime, game->inputCount, game->attemptCount,
+                       game->displayDeadline, game->reactFrom, tickMillis ( &game->tick ),
+                       link->txSequence, link->rxSequence, link->rxCheck, link->count,
+                       stats->retransmissions, stats->duplicates, stats->dropped, stats->mismatches,
+                       stats->unexpected, stats->discarded, stats->longestDelivery };
+    uint32_t digest = digestAdd ( 2166136261UL, play, sizeof ( play ) );
+    int32_t times[ 4 ];
+    uint8_t i, level, difficulty;
+
+    digest = digestAdd ( digest, game->directions.bits, sizeof ( game->directions.bits ) );
+    digest = digestAdd ( digest, stats->rtt, sizeof ( stats->rtt ) );
+
+    for ( i = 0; i < link->count; i++ ) {
+        frame = &link->queue[ ( link->head + i ) % LINK_QUEUE ];
+        digest = digestAdd ( digest, frame, 3 + frame->length );
+    }
+
+    for ( level = 0; level < REACT_LEVELS; level++ ) {
+        for ( difficulty = 0; difficulty < REACT_DIFFICULTIES; difficulty++ ) {
+            cell = reactCell ( &game->reactions, level, difficulty );
+            times[ 0 ] = cell->min;
+            times[ 1 ] = cell->max;
+            times[ 2 ] = cell->mean;
+            times[ 3 ] = cell->count;
+            digest = digestAdd ( digest, times, sizeof ( times ) );
+        }
+    }
+    return digest;
 }
+#endif
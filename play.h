@@ -8,48 +8,130 @@
 #ifndef PLAY_H
 #define PLAY_H
 
+#include <stdint.h>
+#include "tick.h"
+#include "disp.h"
+#include "ir.h"
+#include "dirs.h"
+#include "frame.h"
+#include "input.h"
+#include "react.h"
+#include "trace.h"
+#include "tourn.h"
+#include "link.h"
+#include "pace.h"
+#include "record.h"
+
+
+/**
+ * States of game play, indexing play.c's stateTable
+ */
+enum {
+    STATE_START,
+    STATE_SENDER_LEVEL_PROMPT,
+    STATE_SENDER_DIFFICULTY,
+    STATE_SENDER_CONFIRM,
+    STATE_SENDER_DIRECTIONS,
+    STATE_SENDER_TRANSMIT,
+    STATE_SENDER_OUTCOME,
+    STATE_RECEIVER_PARAMETERS,
+    STATE_RECEIVER_DIRECTIONS,
+    STATE_RECEIVER_PROMPT,
+    STATE_RECEIVER_COUNTDOWN,
+    STATE_RECEIVER_DISPLAY,
+    STATE_RECEIVER_GO,
+    STATE_RECEIVER_REPEAT,
+    STATE_RECEIVER_RESULT,
+    STATE_RECEIVER_LEVEL_WON,
+    STATE_RECEIVER_FAILED,
+    STATE_RECEIVER_GAME_WON,
+    STATE_TOURNAMENT_WAIT,
+    STATE_COUNT
+};
+
+#define STATE_BITS 5
+// bits of the counts of directions, as few as count up to a whole sequence
+#define COUNT_BITS ( DIRECTIONS_CAPACITY < 16 ? 4 : DIRECTIONS_CAPACITY < 32 ? 5 : DIRECTIONS_CAPACITY < 64 ? 6 : 7 )
+
+_Static_assert ( STATE_COUNT <= 1 << STATE_BITS, "states overflow game_t's state field" );
+_Static_assert ( TOURNAMENT_NODES_MAX <= 8, "tournament nodes overflow game_t's node field" );
+_Static_assert ( DIRECTIONS_CAPACITY < 1 << COUNT_BITS, "directions overflow game_t's counts" );
+_Static_assert ( TOURNAMENT_NODES_MAX * ( TOURNAMENT_NODES_MAX - 1 ) <= 1 << 7, "matches overflow game_t's match field" );
+
 
 /**
- * Loops until the nav button has been pushed. This is used for when
- * the game is waiting upon a player's activation for continuation.
+ * Everything one game instance keeps between pacer ticks. A board has
+ * one; a host build can have as many as it likes, side by side. Game
+ * play's own fields are packed into bitfields as narrow as their values,
+ * two to a byte where they fit; none are touched by an interrupt.
  */
-void navPushUpdate ( void );
+typedef struct {
+    tick_t tick;
+    pace_t pace;
+    disp_t disp;
+    ir_t ir;
+    input_t input;
+    input_event_t event;
+    link_t link;
+    directions_t directions;
+    uint8_t state : STATE_BITS, node : 3;
+    uint8_t nodes : 4, numberOfDirections : COUNT_BITS;
+    uint8_t directionsDisplayed : COUNT_BITS, inputCount : COUNT_BITS;
+    uint8_t score : COUNT_BITS, attemptCount : COUNT_BITS;
+    uint8_t match : 7, announcing : 1;
+    deadline_t announceDeadline;
+    char difficulty, gameLevel, counter, charInput, repeatAttempt;
+    uint16_t displayTime;
+    deadline_t displayDeadline;
+    uint16_t reactFrom;
+    react_stats_t reactions;
+    react_report_t peerReactions;
+#ifdef TRACE
+    trace_t trace;
+#endif
+#ifdef RECORD
+    record_t record;
+#endif
+} game_t;
 
 
 /**
- * Starts the game when navswitch button on either board is pushed.
- * Board that navswitch button is pressed becomes player SENDER and
- * a message "R" is transmitted to the other board for declaration
+ * Starts the game at the "START GAME" scroll. Board that navswitch
+ * button is pressed becomes player SENDER and a message "R" is
+ * transmitted to the other board for declaration
  */
-void gameStart ( char *player, int loopRate );
+void playInit ( game_t *game );
 
 
 /**
- *  Player RECEIVER receives the game difficulty chosen by player SENDER,
- * 	as a char and sets the difficulty to determine the temporal rate
- *  for the display of each recepted direction from the SENDER board.
- * 	A confirmation package is transmitted back to the SENDER board.
+ * Puts the game into a tournament of a number of boards, up to
+ * TOURNAMENT_NODES_MAX, as a node from 0. With 0 boards the game is
+ * the usual game of two.
  */
-void setGameParameters ( bool *confirmation );
+void playTournament ( game_t *game, uint8_t node, uint8_t nodes );
 
 
 /**
- * Player SENDER game play schematics
+ * Runs one pacer tick of game play for whichever player this board is.
+ * Never waits, so is called once per pacer tick from the game loop.
  */
-void playerTurnSender ( bool *transmitted, char *play );
+void playTick ( game_t *game );
 
 
 /**
- * Player RECEIVER game play schematics
+ * Returns true while the game only scrolls a message awaiting a push,
+ * so can be run at a lower pacer rate
  */
-void playerTurnReceiver ( bool *gameWon, bool *transmitted, char *play );
+bool playIdle ( const game_t *game );
 
 
+#ifdef RECORD
 /**
- * Declares that the winning player has won by displaying "GAME WON!"
- * on the winning player's LED and resets the game for a new gameLevel.
- * For this new gameLevel, the player roles swap. The player playing the
- * role of RECEIVER starts playing the role of SENDER, and vice-versa.
+ * Returns a digest of the game play: its state and play variables, tick
+ * clock, link sequence numbers, queue and counts, and reaction times.
+ * What the drivers hold, or how long the link was idle, a replay need
+ * not reproduce, so is left out.
  */
-void gameWin ( bool *gameWon, char *play );
+uint32_t playDigest ( const game_t *game );
+#endif
 #endif
@@ -0,0 +1,126 @@
+/**
+* @file     prof.c
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    C program for an interactive memory game between microcontrollers - loop profiling
+*
+* A dump sends one frame per section, sequence numbered by section, as
+* the transmit ring has room for it. Each payload is the section's min,
+* max, total and calls counters, low byte first; the PROF_LOOP frame
+* also carries the overrun count at its end. Every section is timed
+* from the main loop, never an interrupt, so the counters are copied and
+* cleared without masking interrupts.
+*/
+
+#include "prof.h"
+
+#ifdef PROFILE
+
+#include "frame.h"
+
+#define DUMP_PAYLOAD 12
+
+static prof_site_t sites[ PROF_SITES ];
+static uint16_t overruns;
+static uint8_t dumpSite = PROF_SITES;
+
+/**
+ * Clears every section's counters
+ */
+void profInit ( void ) {
+    uint8_t site;
+
+    for ( site = 0; site < PROF_SITES; site++ ) {
+        sites[ site ].min = UINT16_MAX;
+        sites[ site ].max = 0;
+        sites[ site ].total = 0;
+        sites[ site ].calls = 0;
+    }
+    overruns = 0;
+}
+
+/**
+ * Adds one call of a section taking a number of timer ticks
+ */
+void profRecord ( uint8_t site, uint16_t ticks ) {
+    prof_site_t *counters = &sites[ site ];
+
+    if ( ticks < counters->min ) {
+        counters->min = ticks;
+    }
+
+    if ( ticks > counters->max ) {
+        counters->max = ticks;
+    }
+    counters->total += ticks;
+    counters->calls++;
+}
+
+/**
+ * Adds one pass of the main loop, counting it as an overrun if it took
+ * longer than the pacer period it was run at
+ */
+void profLoop ( uint16_t ticks, uint16_t period ) {
+    profRecord ( PROF_LOOP, ticks );
+
+    if ( ticks > period ) {
+        overruns++;
+    }
+}
+
+/**
+ * Copies the counters for a section
+ */
+void profSite ( uint8_t site, prof_site_t *counters ) {
+    *counters = sites[ site ];
+}
+
+/**
+ * Returns the number of main loop passes that overran their pacer period
+ */
+uint16_t profOverruns ( void ) {
+    return overruns;
+}
+
+/**
+ * Starts sending every section's counters over infra-red
+ */
+void profDump ( void ) {
+    if ( dumpSite == PROF_SITES ) {
+        dumpSite = 0;
+    }
+}
+
+/**
+ * Sends the next section's counters of a dump if the transmit ring has
+ * room for its frame, clearing the counters once all have gone
+ */
+void profDumpUpdate ( ir_t *ir ) {
+    prof_site_t counters;
+    uint8_t payload[ DUMP_PAYLOAD ];
+    uint8_t length = dumpSite == PROF_LOOP ? DUMP_PAYLOAD : DUMP_PAYLOAD - 2;
+
+    if ( ( dumpSite == PROF_SITES ) || !frameRoom ( ir, length ) ) {
+        return;
+    }
+    profSite ( dumpSite, &counters );
+    payload[ 0 ] = counters.min;
+    payload[ 1 ] = counters.min >> 8;
+    payload[ 2 ] = counters.max;
+    payload[ 3 ] = counters.max >> 8;
+    payload[ 4 ] = counters.total;
+    payload[ 5 ] = counters.total >> 8;
+    payload[ 6 ] = counters.total >> 16;
+    payload[ 7 ] = counters.total >> 24;
+    payload[ 8 ] = counters.calls;
+    payload[ 9 ] = counters.calls >> 8;
+    payload[ 10 ] = overruns;
+    payload[ 11 ] = overruns >> 8;
+    frameSend ( ir, FRAME_PROFILE, dumpSite, payload, length );
+
+    if ( ++dumpSite == PROF_SITES ) {
+        profInit ();
+    }
+}
+
+#endif
@@ -0,0 +1,117 @@
+/**
+* @file     prof.h
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Header file for prof.c of the interactive memory game between microcontrollers - loop profiling
+*
+* Build with "make PROFILE=1" to time the main loop and each game
+* state's update against the free-running timer 1 the pacer uses.
+* Without PROFILE the hooks compile to nothing. Pushing the board's
+* button sends the counters over infra-red and starts them afresh.
+*
+* A timer 1 tick is 128 us, TIMER_RATE being 8 MHz / 1024, and timer 0
+* drives the infra-red carrier, so there is no faster counter to read.
+* The matrix scan, navswitch sample, infra-red poll and displayChar ()
+* take a few microseconds, starting just after a tick as the pacer and
+* their interrupts fall on one, so nearly every call would read 0 ticks.
+* They are not timed here: sim/budget.out counts the calls they make on
+* the host. Only spans that can run past a tick are timed.
+*/
+
+#ifndef PROF_H
+#define PROF_H
+
+#include <stdint.h>
+#include "ir.h"
+#include "play.h"
+
+#define FRAME_PROFILE 'P'
+
+
+/**
+ * The sections of code timed: a pass of the main loop, then one per
+ * game state's update
+ */
+enum {
+    PROF_LOOP,
+    PROF_STATE,
+    PROF_SITES = PROF_STATE + STATE_COUNT
+};
+
+
+/**
+ * Timer ticks taken by one section of code over its calls
+ */
+typedef struct {
+    uint16_t min;
+    uint16_t max;
+    uint32_t total;
+    uint16_t calls;
+} prof_site_t;
+
+
+#ifdef PROFILE
+
+#include "timer.h"
+
+#define PROF_BEGIN(start) timer_tick_t start = paceTimer ()
+#define PROF_END(start, site) profRecord ( ( site ), paceTimer () - start )
+#define PROF_LOOP_END(start, period) profLoop ( paceTimer () - start, ( period ) )
+
+
+/**
+ * Clears every section's counters
+ */
+void profInit ( void );
+
+
+/**
+ * Adds one call of a section taking a number of timer ticks
+ */
+void profRecord ( uint8_t site, uint16_t ticks );
+
+
+/**
+ * Adds one pass of the main loop, counting it as an overrun if it took
+ * longer than the pacer period it was run at
+ */
+void profLoop ( uint16_t ticks, uint16_t period );
+
+
+/**
+ * Copies the counters for a section
+ */
+void profSite ( uint8_t site, prof_site_t *counters );
+
+
+/**
+ * Returns the number of main loop passes that overran their pacer period
+ */
+uint16_t profOverruns ( void );
+
+
+/**
+ * Starts sending every section's counters over infra-red
+ */
+void profDump ( void );
+
+
+/**
+ * Sends the next section's counters of a dump if the transmit ring has
+ * room for its frame, clearing the counters once all have gone
+ */
+void profDumpUpdate ( ir_t *ir );
+
+#else
+
+#define PROF_BEGIN(start)
+#define PROF_END(start, site)
+#define PROF_LOOP_END(start, period)
+
+#define profInit()
+#define profDump()
+#define profDumpUpdate(ir)
+
+#endif
+
+#endif
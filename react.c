@@ -0,0 +1,101 @@
+/**
+* @file     react.c
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    C program for an interactive memory game between microcontrollers - reaction times
+*
+* A frame of reaction times carries the level, the difficulty, the count,
+* then the min, the mean and the max, each low byte first.
+*/
+
+#include "frame.h"
+#include "link.h"
+#include "react.h"
+
+#define MEAN_FRACTION 4 // bits
+
+/**
+ * Clears the reaction times of every level and difficulty
+ */
+void reactInit ( react_stats_t *stats ) {
+    uint8_t level, difficulty;
+
+    for ( level = 0; level < REACT_LEVELS; level++ ) {
+        for ( difficulty = 0; difficulty < REACT_DIFFICULTIES; difficulty++ ) {
+            stats->cells[ level ][ difficulty ].min = UINT16_MAX;
+            stats->cells[ level ][ difficulty ].max = 0;
+            stats->cells[ level ][ difficulty ].mean = 0;
+            stats->cells[ level ][ difficulty ].count = 0;
+        }
+    }
+}
+
+/**
+ * Adds a reaction time to a level, 0 the first, at a difficulty, 0 the
+ * easiest. The mean moves a count'th of the way to the new time, so is
+ * exact until the count saturates.
+ */
+void reactRecord ( react_stats_t *stats, uint8_t level, uint8_t difficulty, uint16_t milliseconds ) {
+    react_t *cell = &stats->cells[ level ][ difficulty ];
+    int32_t sample = ( milliseconds < REACT_MEAN_MAX ? milliseconds : REACT_MEAN_MAX ) << MEAN_FRACTION;
+
+    if ( milliseconds < cell->min ) {
+        cell->min = milliseconds;
+    }
+
+    if ( milliseconds > cell->max ) {
+        cell->max = milliseconds;
+    }
+
+    if ( cell->count < UINT8_MAX ) {
+        cell->count++;
+    }
+    cell->mean += ( sample - cell->mean ) / cell->count;
+}
+
+/**
+ * Returns the reaction times of a level at a difficulty
+ */
+const react_t *reactCell ( const react_stats_t *stats, uint8_t level, uint8_t difficulty ) {
+    return &stats->cells[ level ][ difficulty ];
+}
+
+/**
+ * Sends the reaction times of a level at a difficulty in a frame over
+ * the reliable link
+ */
+void reactSend ( link_t *link, const react_stats_t *stats, uint8_t level, uint8_t difficulty ) {
+    const react_t *cell = reactCell ( stats, level, difficulty );
+    uint8_t payload[ REACT_PAYLOAD ];
+
+    payload[ 0 ] = level;
+    payload[ 1 ] = difficulty;
+    payload[ 2 ] = cell->count;
+    payload[ 3 ] = cell->min;
+    payload[ 4 ] = cell->min >> 8;
+    payload[ 5 ] = cell->mean;
+    payload[ 6 ] = cell->mean >> 8;
+    payload[ 7 ] = cell->max;
+    payload[ 8 ] = cell->max >> 8;
+    linkSend ( link, FRAME_REACTIONS, payload, REACT_PAYLOAD );
+}
+
+/**
+ * Reads the reaction times from a received frame, returning false if
+ * the frame does not hold them
+ */
+bool reactReceive ( const frame_t *frame, react_report_t *report ) {
+    const uint8_t *payload = frame->payload;
+
+    if ( ( frame->type != FRAME_REACTIONS ) || ( frame->length != REACT_PAYLOAD )
+            || ( payload[ 0 ] >= REACT_LEVELS ) || ( payload[ 1 ] >= REACT_DIFFICULTIES ) ) {
+        return false;
+    }
+    report->level = payload[ 0 ];
+    report->difficulty = payload[ 1 ];
+    report->times.count = payload[ 2 ];
+    report->times.min = payload[ 3 ] | payload[ 4 ] << 8;
+    report->times.mean = payload[ 5 ] | payload[ 6 ] << 8;
+    report->times.max = payload[ 7 ] | payload[ 8 ] << 8;
+    return true;
+}
@@ -0,0 +1,86 @@
+/**
+* @file     react.h
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Header file for react.c of the interactive memory game between microcontrollers - reaction times
+*/
+
+#ifndef REACT_H
+#define REACT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "frame.h"
+#include "link.h"
+
+#define REACT_LEVELS LEVEL_COUNT
+#define REACT_DIFFICULTIES 3
+#define REACT_MEAN_MAX 4095 // ms, the most a time adds to a mean
+#define REACT_PAYLOAD FRAME_REPORT_PAYLOAD
+#define FRAME_REACTIONS 'T'
+
+_Static_assert ( REACT_PAYLOAD <= FRAME_PAYLOAD_MAX, "reaction reports overflow a frame" );
+
+
+/**
+ * Reaction times of one level at one difficulty, in milliseconds. The
+ * mean is fixed point with 4 fractional bits, and once count reaches
+ * 255 becomes a moving average over about the last 255 times.
+ */
+typedef struct {
+    uint16_t min;
+    uint16_t max;
+    uint16_t mean;
+    uint8_t count;
+} react_t;
+
+
+/**
+ * Reaction times of every level at every difficulty
+ */
+typedef struct {
+    react_t cells[ REACT_LEVELS ][ REACT_DIFFICULTIES ];
+} react_stats_t;
+
+
+/**
+ * One level's reaction times as reported by the other board
+ */
+typedef struct {
+    uint8_t level;
+    uint8_t difficulty;
+    react_t times;
+} react_report_t;
+
+
+/**
+ * Clears the reaction times of every level and difficulty
+ */
+void reactInit ( react_stats_t *stats );
+
+
+/**
+ * Adds a reaction time to a level, 0 the first, at a difficulty, 0 the easiest
+ */
+void reactRecord ( react_stats_t *stats, uint8_t level, uint8_t difficulty, uint16_t milliseconds );
+
+
+/**
+ * Returns the reaction times of a level at a difficulty
+ */
+const react_t *reactCell ( const react_stats_t *stats, uint8_t level, uint8_t difficulty );
+
+
+/**
+ * Sends the reaction times of a level at a difficulty in a frame over
+ * the reliable link
+ */
+void reactSend ( link_t *link, const react_stats_t *stats, uint8_t level, uint8_t difficulty );
+
+
+/**
+ * Reads the reaction times from a received frame, returning false if
+ * the frame does not hold them
+ */
+bool reactReceive ( const frame_t *frame, react_report_t *report );
+#endif
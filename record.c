@@ -0,0 +1,184 @@
+/**
+* @file     record.c
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    C program for an interactive memory game between microcontrollers - input recording
+*
+* A record is one byte, its kind in the top bits and the passes since
+* the last record in the low RECORD_DELTA_BITS, then its value, low byte
+* first. Passes of RECORD_DELTA_LONG or more are given as
+* RECORD_DELTA_LONG, with the passes following as a varint: seven bits
+* a byte, low first, the top bit set on all but the last byte. Most
+* records are a pass or two apart, so take one byte more than their
+* value. A streamed log is staged whole records at a time and sent in
+* frames of FRAME_RECORD_BYTES, numbered in turn from 0, so a capture
+* missing any shows a gap. A record with no room left in the stage ends
+* the log before it, as the log is no use to a replay past a lost byte.
+*/
+
+#include "record.h"
+
+#ifdef RECORD
+
+#include "frame.h"
+#include <string.h>
+
+#ifdef __AVR__
+static record_t *record;
+#else
+static _Thread_local record_t *record;
+#endif
+
+/**
+ * Initialiser for a log, not yet written, stamped from a game loop's passes
+ */
+void recordInit ( record_t *log, const pace_t *pace ) {
+    log->write = 0;
+    log->context = 0;
+    log->pace = pace;
+    log->last = 0;
+    log->txTail = 0;
+    log->ir = 0;
+    log->sequence = 0;
+    log->staged = 0;
+}
+
+/**
+ * Selects the log the calling thread's records are written to
+ */
+void recordSelect ( record_t *log ) {
+    record = log;
+}
+
+/**
+ * Starts writing a log, with its header
+ */
+void recordStart ( record_t *log, record_write_t *write, void *context, uint8_t node, uint8_t nodes ) {
+    uint8_t header[ RECORD_MAGIC_BYTES + 2 ];
+
+    memcpy ( header, RECORD_MAGIC, RECORD_MAGIC_BYTES );
+    header[ RECORD_MAGIC_BYTES ] = node;
+    header[ RECORD_MAGIC_BYTES + 1 ] = nodes;
+    log->write = write;
+    log->context = context;
+    log->last = paceStats ( log->pace )->passes;
+    write ( context, header, sizeof ( header ) );
+}
+
+/**
+ * Writes a record of a streamed log to its stage, ending the log
+ * instead if the stage has no room for it
+ */
+static void recordStage ( void *context, const uint8_t *bytes, uint8_t length ) {
+    record_t *log = context;
+
+    if ( log->staged + length > RECORD_STAGE_BYTES ) {
+        log->write = 0;
+        return;
+    }
+    memcpy ( &log->stage[ log->staged ], bytes, length );
+    log->staged += length;
+}
+
+/**
+ * Starts streaming a log over infra-red with its header
+ */
+void recordStream ( record_t *log, ir_t *ir, uint8_t node, uint8_t nodes ) {
+    log->ir = ir;
+    log->sequence = 0;
+    log->staged = 0;
+    recordStart ( log, recordStage, log, node, nodes );
+}
+
+/**
+ * Queues a streamed log's next frame once the last is off the wire: a
+ * full frame, or once the log has ended, what is left. Returns true
+ * while any of the log is left to queue.
+ */
+bool recordStreamUpdate ( record_t *log ) {
+    uint8_t length = log->staged < FRAME_RECORD_BYTES ? log->staged : FRAME_RECORD_BYTES;
+
+    if ( log->ir && length && ( !log->write || ( length == FRAME_RECORD_BYTES ) )
+         && frameSendLog ( log->ir, log->sequence, log->stage, length ) ) {
+        log->sequence = ( log->sequence + 1 ) % RECORD_SEQUENCES;
+        log->staged -= length;
+        memmove ( log->stage, &log->stage[ length ], log->staged );
+    }
+    return log->staged > 0;
+}
+
+/**
+ * Logs a record of up to four bytes of value, stamped with the passes
+ * since the last record
+ */
+static void recordPut ( uint8_t kind, const uint8_t *value, uint8_t length ) {
+    uint8_t bytes[ 1 + 5 + 4 ];
+    uint32_t pass = paceStats ( record->pace )->passes;
+    uint32_t delta = pass - record->last;
+    uint8_t count = 1;
+
+    if ( delta < RECORD_DELTA_LONG ) {
+        bytes[ 0 ] = kind << RECORD_DELTA_BITS | delta;
+    } else {
+        bytes[ 0 ] = kind << RECORD_DELTA_BITS | RECORD_DELTA_LONG;
+
+        for ( ; delta >= 0x80; delta >>= 7 ) {
+            bytes[ count++ ] = delta | 0x80;
+        }
+        bytes[ count++ ] = delta;
+    }
+    memcpy ( &bytes[ count ], value, length );
+    record->last = pass;
+    record->write ( record->context, bytes, count + length );
+}
+
+/**
+ * Logs a press taken, to the selected log
+ */
+void recordNav ( const input_event_t *event ) {
+    uint8_t value[ 3 ] = { event->navswitch, event->time, event->time >> 8 };
+
+    if ( record && record->write ) {
+        recordPut ( RECORD_NAV, value, sizeof ( value ) );
+    }
+}
+
+/**
+ * Logs a record of one or two bytes of value, to the selected log
+ */
+void recordBytes ( uint8_t kind, uint8_t low, uint8_t high, uint8_t length ) {
+    uint8_t value[ 2 ] = { low, high };
+
+    if ( record && record->write ) {
+        recordPut ( kind, value, length );
+    }
+}
+
+/**
+ * Logs the bytes the UART has taken from the transmit ring since the
+ * last pass, if any. The ring's tail only moves as bytes are taken.
+ */
+void recordPass ( ir_t *ir ) {
+    uint8_t taken = ir->tx.tail - record->txTail;
+
+    record->txTail = ir->tx.tail;
+
+    if ( taken ) {
+        RECORD_BYTE ( RECORD_IR_TX, taken );
+    }
+}
+
+/**
+ * Ends the selected log with the last pass and a digest of the game
+ * play it left. Nothing more is logged.
+ */
+void recordEnd ( uint32_t digest ) {
+    uint8_t value[ 4 ] = { digest, digest >> 8, digest >> 16, digest >> 24 };
+
+    if ( record && record->write ) {
+        recordPut ( RECORD_END, value, sizeof ( value ) );
+        record->write = 0;
+    }
+}
+
+#endif
@@ -0,0 +1,158 @@
+/**
+* @file     record.h
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Header file for record.c of the interactive memory game between microcontrollers - input recording
+*
+* Build with RECORD to log everything from outside that one board's
+* game play acts on, each stamped with the loop pass it was acted on in:
+* the navswitch presses it takes, the infra-red bytes it reads, the
+* bytes the UART takes from its transmit ring, and the sample clock
+* whenever it is read. Given the log, the game plays out the same again
+* pass for pass, with no other board, as sim/replay does. Without RECORD
+* the hooks compile to nothing. The host simulation writes logs to
+* files. A board built with RECORD streams its log over infra-red from
+* power on, in FRAME_RECORD frames, and a push of its button ends the
+* log with a digest of its game play. A frame goes out only while the
+* game has nothing queued, any game byte cuts it short to be sent again
+* whole, and the UART taking it is not logged, so the game's bytes wait
+* at most one byte time on it. Every parser passes the frames over
+* without counting them discarded, so the peer plays as it would with
+* the log off, which make check checks. A peer built with RECORD would
+* still log their bytes, so record one board of a pair.
+*/
+
+#ifndef RECORD_H
+#define RECORD_H
+
+#include <stdint.h>
+#include "input.h"
+#include "ir.h"
+#include "pace.h"
+
+#define RECORD_MAGIC "UCFKREC1"
+#define RECORD_MAGIC_BYTES 8
+#define RECORD_DELTA_BITS 5
+#define RECORD_DELTA_LONG 31 // the passes since the last record follow as a varint
+#define RECORD_STAGE_BYTES 96 // log bytes a streamed log holds until there is room to send them
+#define RECORD_SEQUENCES 128 // frame sequence numbers, in turn from 0
+
+
+/**
+ * The kinds of record, each followed by its value
+ */
+enum {
+    RECORD_NAV, // a press taken: navswitch, then its time, 2 bytes
+    RECORD_IR_RX, // a recepted byte read
+    RECORD_IR_TX, // bytes taken from the transmit ring since the last pass, 1 byte
+    RECORD_MILLIS, // the sample clock read, 2 bytes
+    RECORD_END, // the log's last pass, its game play digest, 4 bytes
+    RECORD_KINDS
+};
+
+
+/**
+ * Writes bytes of a log to wherever it is kept
+ */
+typedef void record_write_t ( void *context, const uint8_t *bytes, uint8_t length );
+
+
+/**
+ * One game's log: where it is written, the passes it is stamped from,
+ * the pass of the last record, and how far the UART had taken the
+ * transmit ring by the last pass. Nothing is logged until recordStart (),
+ * nor after recordEnd (). A log streamed over infra-red also has the
+ * queues it is sent on, the sequence number of its next frame, and the
+ * bytes not yet sent.
+ */
+typedef struct {
+    record_write_t *write;
+    void *context;
+    const pace_t *pace;
+    uint32_t last;
+    uint8_t txTail;
+    ir_t *ir;
+    uint8_t sequence, staged;
+    uint8_t stage[ RECORD_STAGE_BYTES ];
+} record_t;
+
+
+#ifdef RECORD
+
+#define RECORD_NAV(event) recordNav ( event )
+#define RECORD_BYTE(kind, byte) recordBytes ( ( kind ), ( byte ), 0, 1 )
+#define RECORD_WORD(kind, word) recordBytes ( ( kind ), ( word ), ( word ) >> 8, 2 )
+
+/**
+ * Initialiser for a log, not yet written, stamped from a game loop's passes
+ */
+void recordInit ( record_t *record, const pace_t *pace );
+
+
+/**
+ * Selects the log the calling thread's records are written to
+ */
+void recordSelect ( record_t *record );
+
+
+/**
+ * Starts writing the selected log, with its header: RECORD_MAGIC, then
+ * the game's tournament node and nodes
+ */
+void recordStart ( record_t *record, record_write_t *write, void *context, uint8_t node, uint8_t nodes );
+
+
+/**
+ * Starts streaming a log over infra-red with its header, as recordStart ()
+ * does. Should the log's bytes outrun the line, it ends there.
+ */
+void recordStream ( record_t *record, ir_t *ir, uint8_t node, uint8_t nodes );
+
+
+/**
+ * Queues a streamed log's next frame once the last is off the wire: a
+ * full one, or once the log has ended, what is left. Returns true while
+ * any is left. Called each pass.
+ */
+bool recordStreamUpdate ( record_t *record );
+
+
+/**
+ * Logs a press taken, to the selected log
+ */
+void recordNav ( const input_event_t *event );
+
+
+/**
+ * Logs a record of one or two bytes of value, to the selected log
+ */
+void recordBytes ( uint8_t kind, uint8_t low, uint8_t high, uint8_t length );
+
+
+/**
+ * Logs the bytes the UART has taken from the transmit ring since the
+ * last pass. Called at the start of each pass.
+ */
+void recordPass ( ir_t *ir );
+
+
+/**
+ * Ends the selected log with the last pass and a digest of the game
+ * play it left. Nothing more is logged.
+ */
+void recordEnd ( uint32_t digest );
+
+#else
+
+#define RECORD_NAV(event) ( ( void ) 0 )
+#define RECORD_BYTE(kind, byte) ( ( void ) 0 )
+#define RECORD_WORD(kind, word) ( ( void ) 0 )
+
+#define recordInit(record, pace)
+#define recordSelect(record)
+#define recordPass(ir)
+#define recordStreamUpdate(record)
+
+#endif
+
+#endif
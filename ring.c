@@ -0,0 +1,70 @@
+/**
+* @file     ring.c
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    C program for an interactive memory game between microcontrollers - byte ring buffers
+*
+* Head and tail run freely and are masked on use, so a full buffer holds
+* RING_SIZE bytes. The acquire/release accesses publish a byte before the
+* index that covers it; on the AVR these are plain 8 bit loads and stores,
+* and on a host they keep a producer thread and consumer thread in order.
+*/
+
+#include "ring.h"
+
+#define RING_MASK ( RING_SIZE - 1 )
+
+/**
+ * Empties a ring buffer and clears its overrun count
+ */
+void ringInit ( ring_t *ring ) {
+    ring->head = 0;
+    ring->tail = 0;
+    ring->overruns = 0;
+}
+
+/**
+ * Producer side. Adds a byte to a ring buffer, or counts an
+ * overrun and returns false if the buffer is full.
+ */
+bool ringPut ( ring_t *ring, uint8_t byte ) {
+    uint8_t head = ring->head;
+
+    if ( ringFree ( ring ) == 0 ) {
+        ring->overruns++;
+        return false;
+    }
+    ring->data[ head & RING_MASK ] = byte;
+    __atomic_store_n ( &ring->head, ( uint8_t ) ( head + 1 ), __ATOMIC_RELEASE );
+    return true;
+}
+
+/**
+ * Consumer side. Takes the oldest byte from a ring buffer,
+ * returning false if the buffer is empty.
+ */
+bool ringGet ( ring_t *ring, uint8_t *byte ) {
+    uint8_t tail = ring->tail;
+
+    if ( __atomic_load_n ( &ring->head, __ATOMIC_ACQUIRE ) == tail ) {
+        return false;
+    }
+    *byte = ring->data[ tail & RING_MASK ];
+    __atomic_store_n ( &ring->tail, ( uint8_t ) ( tail + 1 ), __ATOMIC_RELEASE );
+    return true;
+}
+
+/**
+ * Either side. Returns the number of bytes in a ring buffer.
+ */
+uint8_t ringCount ( ring_t *ring ) {
+    return __atomic_load_n ( &ring->head, __ATOMIC_ACQUIRE ) - __atomic_load_n ( &ring->tail, __ATOMIC_ACQUIRE );
+}
+
+/**
+ * Either side. Returns the number of bytes a ring buffer has room for,
+ * all of which ringPut () will take.
+ */
+uint8_t ringFree ( ring_t *ring ) {
+    return RING_SIZE - ringCount ( ring );
+}
@@ -0,0 +1,61 @@
+/**
+* @file     ring.h
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Header file for ring.c of the interactive memory game between microcontrollers - byte ring buffers
+*/
+
+#ifndef RING_H
+#define RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define RING_SIZE 32 // power of two, at most 128
+
+
+/**
+ * Lock-free byte ring buffer for a single producer, such as an
+ * interrupt, and a single consumer, such as the game loop.
+ * Only the producer writes head and overruns, only the consumer tail.
+ */
+typedef struct {
+    uint8_t head;
+    uint8_t tail;
+    uint16_t overruns;
+    uint8_t data[ RING_SIZE ];
+} ring_t;
+
+
+/**
+ * Empties a ring buffer and clears its overrun count
+ */
+void ringInit ( ring_t *ring );
+
+
+/**
+ * Producer side. Adds a byte to a ring buffer, or counts an
+ * overrun and returns false if the buffer is full.
+ */
+bool ringPut ( ring_t *ring, uint8_t byte );
+
+
+/**
+ * Consumer side. Takes the oldest byte from a ring buffer,
+ * returning false if the buffer is empty.
+ */
+bool ringGet ( ring_t *ring, uint8_t *byte );
+
+
+/**
+ * Either side. Returns the number of bytes in a ring buffer.
+ */
+uint8_t ringCount ( ring_t *ring );
+
+
+/**
+ * Either side. Returns the number of bytes a ring buffer has room for,
+ * all of which ringPut () will take.
+ */
+uint8_t ringFree ( ring_t *ring );
+#endif
@@ -0,0 +1,372 @@
+/**
+* @file     board.c
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    C program for the host simulation of the interactive memory game - virtual boards
+*/
+
+#include "ledmat.h"
+#include "board.h"
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * Initialiser for a board and its game
+ */
+void boardInit ( board_t *board ) {
+    memset ( board, 0, sizeof ( *board ) );
+    halSelect ( &board->hal );
+    gameInit ( &board->game );
+}
+
+/**
+ * Runs the navswitch sample interrupts that would have fallen in a
+ * tick's pacer wait, and returns true if the wait ends in a pass of the
+ * board's game loop, at the rate it is paced at
+ */
+bool boardWait ( board_t *board ) {
+    halSelect ( &board->hal );
+
+    for ( board->sampleCarry += INPUT_SAMPLE_RATE; board->sampleCarry >= PACER_RATE; board->sampleCarry -= PACER_RATE ) {
+        inputSample ( &board->game.input );
+    }
+    board->loopCarry += board->game.pace.rate;
+
+    if ( board->loopCarry < PACER_RATE ) {
+        return false;
+    }
+    board->loopCarry -= PACER_RATE;
+    paceWait ( &board->game.pace );
+    return true;
+}
+
+/**
+ * Runs the matrix scan interrupts that would have fallen in a tick
+ */
+void boardScan ( board_t *board ) {
+    matrix_t *matrix = &board->game.disp.matrix;
+    uint8_t column, pattern;
+
+    for ( board->scanCarry += MATRIX_SCAN_RATE; board->scanCarry >= PACER_RATE; board->scanCarry -= PACER_RATE ) {
+        pattern = matrixScan ( matrix, &column );
+        ledmat_display_column ( pattern, column );
+    }
+}
+
+/**
+ * Runs the navswitch sample interrupts that would have fallen in the
+ * pacer wait, then a pass of a board's game loop if one is due at the
+ * rate it is paced at, then the matrix scan interrupts that would have
+ * fallen in the tick
+ */
+void boardTick ( board_t *board ) {
+    if ( boardWait ( board ) ) {
+        gameTick ( &board->game );
+    }
+    boardScan ( board );
+}
+
+/**
+ * Writes bytes of a board's log to its file
+ */
+static void boardLogWrite ( void *context, const uint8_t *bytes, uint8_t length ) {
+    fwrite ( bytes, 1, length, context );
+}
+
+/**
+ * Starts recording a board's game, before its first tick, to a log file
+ * named by a prefix and the board's letter. Returns false if the file
+ * cannot be written.
+ */
+bool boardRecord ( board_t *board, const char *prefix, char letter ) {
+    game_t *game = &board->game;
+    char path[ 256 ];
+
+    snprintf ( path, sizeof ( path ), "%s.%c", prefix, letter );
+    board->log = fopen ( path, "wb" );
+
+    if ( !board->log ) {
+        return false;
+    }
+    recordStart ( &game->record, boardLogWrite, board->log, game->node, game->nodes );
+    return true;
+}
+
+/**
+ * Ends a board's log with the digest of its game play, and closes it.
+ * Returns false if the file could not be written.
+ */
+bool boardRecordEnd ( board_t *board ) {
+    bool written;
+
+    recordSelect ( &board->game.record );
+    recordEnd ( boardDigest ( board ) );
+    written = !ferror ( board->log );
+    written = ( fclose ( board->log ) == 0 ) && written;
+    board->log = 0;
+    return written;
+}
+
+/**
+ * Takes a board's next byte for the wire, capturing it if the board's
+ * transmission is captured
+ */
+static bool boardTransmit ( board_t *board, uint8_t *byte ) {
+    if ( !irTransmitByte ( &board->game.ir, byte ) ) {
+        return false;
+    }
+
+    if ( board->capture ) {
+        fputc ( *byte, board->capture );
+    }
+    return true;
+}
+
+/**
+ * Starts streaming a board's game log over infra-red, before its first
+ * tick, and captures every byte it transmits to a file. Returns false
+ * if the file cannot be written.
+ */
+bool boardStream ( board_t *board, const char *path ) {
+    game_t *game = &board->game;
+
+    board->capture = fopen ( path, "wb" );
+
+    if ( !board->capture ) {
+        return false;
+    }
+    recordStream ( &game->record, &game->ir, game->node, game->nodes );
+    return true;
+}
+
+/**
+ * Ends a board's streamed log with the digest of its game play, captures
+ * the rest of its transmission, and closes the capture. Returns false if
+ * it could not be written.
+ */
+bool boardStreamEnd ( board_t *board ) {
+    record_t *log = &board->game.record;
+    uint8_t byte;
+    bool more, written;
+
+    recordSelect ( log );
+    recordEnd ( boardDigest ( board ) );
+
+    do {
+        more = recordStreamUpdate ( log );
+
+        while ( boardTransmit ( board, &byte ) ) {
+        }
+    } while ( more );
+    written = !ferror ( board->capture );
+    written = ( fclose ( board->capture ) == 0 ) && written;
+    board->capture = 0;
+    return written;
+}
+
+/**
+ * Returns a digest of a board's game play
+ */
+uint32_t boardDigest ( const board_t *board ) {
+    return playDigest ( &board->game );
+}
+
+/**
+ * Queues a navswitch push for the board's next navswitch sample
+ */
+void boardNavPush ( board_t *board, uint8_t navswitch ) {
+    board->hal.navPending |= 1 << navswitch;
+}
+
+/**
+ * Returns whether the board's LED is on
+ */
+bool boardLed ( const board_t *board ) {
+    return board->hal.ledState;
+}
+
+/**
+ * Describes what the board is displaying: a quoted scrolling string,
+ * a char in single quotes, or an empty string for nothing
+ */
+const char *boardDisplay ( board_t *board ) {
+    hal_t *hal = &board->hal;
+    const char *scrolling = displayScrolling ( &board->game.disp );
+
+    if ( scrolling ) {
+        snprintf ( hal->description, sizeof ( hal->description ), "\"%s\"", scrolling );
+    } else if ( displayShownChar ( &board->game.disp ) ) {
+        snprintf ( hal->description, sizeof ( hal->description ), "'%c'", displayShownChar ( &board->game.disp ) );
+    } else {
+        hal->description[ 0 ] = 0;
+    }
+    return hal->description;
+}
+
+/**
+ * Returns the next number of a small xorshift generator, and steps its
+ * seed on
+ */
+uint32_t boardRandom ( uint32_t *seed ) {
+    *seed ^= *seed << 13;
+    *seed ^= *seed >> 17;
+    *seed ^= *seed << 5;
+    return *seed;
+}
+
+/**
+ * Returns true if a byte on a channel is to be lost, drawing from the
+ * channel's own xorshift generator
+ */
+static bool channelLoses ( channel_t *channel ) {
+    if ( !channel->lossPerMille ) {
+        return false;
+    }
+    if ( boardRandom ( &channel->seed ) % 1000 >= channel->lossPerMille ) {
+        return false;
+    }
+    channel->lost++;
+    return true;
+}
+
+/**
+ * Moves bytes along one direction of the infra-red channel. A byte is
+ * taken from the sender's queue when the wire is free and delivered to
+ * the peer one byte time later, unless lost.
+ */
+void channelUpdate ( board_t *from, board_t *to, uint64_t now ) {
+    channel_t *channel = &from->out;
+
+    if ( channel->inFlight && ( now >= channel->busyUntil ) ) {
+        if ( !channelLoses ( channel ) ) {
+            irReceiveByte ( &to->game.ir, channel->byte );
+        }
+        channel->inFlight = false;
+    }
+
+    if ( !channel->inFlight && boardTransmit ( from, &channel->byte ) ) {
+        channel->busyUntil = ( channel->busyUntil > now ? channel->busyUntil : now ) + BYTE_NS;
+        channel->inFlight = true;
+        channel->bytes++;
+    }
+}
+
+/**
+ * Moves bytes across an infra-red channel shared by a number of boards.
+ * A byte taken from a board's queue reaches every other board one byte
+ * time later, unless another board's byte was on the channel at the
+ * same time, in which case both are lost, or it is lost anyway.
+ */
+void mediumUpdate ( board_t *boards, int count, uint64_t now ) {
+    channel_t *channel, *other;
+    int i, j;
+
+    for ( i = 0; i < count; i++ ) {
+        channel = &boards[ i ].out;
+
+        if ( channel->inFlight && ( now >= channel->busyUntil ) ) {
+            bool lost = channel->collided || channelLoses ( channel );
+
+            for ( j = 0; ( j < count ) && !lost; j++ ) {
+                if ( j != i ) {
+                    irReceiveByte ( &boards[ j ].game.ir, channel->byte );
+                }
+            }
+            channel->inFlight = false;
+        }
+    }
+
+    for ( i = 0; i < count; i++ ) {
+        channel = &boards[ i ].out;
+
+        if ( channel->inFlight || !boardTransmit ( &boards[ i ], &channel->byte ) ) {
+            continue;
+        }
+        channel->busyUntil = ( channel->busyUntil > now ? channel->busyUntil : now ) + BYTE_NS;
+        channel->inFlight = true;
+        channel->collided = false;
+        channel->bytes++;
+
+        for ( j = 0; j < count; j++ ) {
+            other = &boards[ j ].out;
+
+            if ( ( j != i ) && other->inFlight ) {
+                other->collided = true;
+                channel->collided = true;
+                channel->collisions++;
+            }
+        }
+    }
+}
+
+/**
+ * A player: pushes the navswitch at random a percentage of the time,
+ * and otherwise repeats the directions it was shown, enters random
+ * ones, raises the difficulty now and then and pushes wherever the game
+ * awaits a push
+ */
+void boardPlay ( board_t *board, uint8_t monkeyPercent, uint32_t *seed ) {
+    static const char directions[] = "NESW";
+    game_t *game = &board->game;
+    uint8_t navswitch = NAVSWITCH_PUSH;
+
+    if ( boardRandom ( seed ) % 100 < monkeyPercent ) {
+        navswitch = boardRandom ( seed ) % NAVSWITCH_NUM;
+    } else if ( game->state == STATE_RECEIVER_REPEAT ) {
+        navswitch = strchr ( directions, directionsGet ( &game->directions, game->attemptCount ) ) - directions;
+    } else if ( game->state == STATE_SENDER_DIRECTIONS ) {
+        navswitch = boardRandom ( seed ) % 4;
+    } else if ( ( game->state == STATE_SENDER_DIFFICULTY ) && ( boardRandom ( seed ) % 2 ) ) {
+        navswitch = NAVSWITCH_NORTH;
+    }
+    boardNavPush ( board, navswitch );
+}
+
+/**
+ * Initialises a number of boards, as a tournament if there are more
+ * than two, and plays them as a run sets out, each pushed by a player
+ * every PLAYER_DELAY ms
+ */
+void boardsRun ( board_t *boards, int count, board_run_t *run ) {
+    unsigned long tick, ticks = run->minutes * 60UL * PACER_RATE;
+    int i;
+
+    run->now = 0;
+
+    for ( i = 0; i < count; i++ ) {
+        boardInit ( &boards[ i ] );
+
+        if ( count > 2 ) {
+            playTournament ( &boards[ i ].game, i, count );
+        }
+    }
+
+    for ( tick = 0; ( tick < ticks ) && !( run->untilWon && ( count == 2 )
+          && ( boards[ 1 ].game.state == STATE_RECEIVER_GAME_WON ) ); tick++ ) {
+        for ( i = 0; i < count; i++ ) {
+            if ( ( tick + i * 7 ) % ( PACER_RATE * PLAYER_DELAY / 1000 ) == 0 ) {
+                boardPlay ( &boards[ i ], run->monkeyPercent, &run->seed );
+            }
+
+            if ( boardWait ( &boards[ i ] ) ) {
+                if ( run->before ) {
+                    run->before ( run, &boards[ i ], i );
+                }
+                gameTick ( &boards[ i ].game );
+
+                if ( run->after ) {
+                    run->after ( run, &boards[ i ], i );
+                }
+            }
+            boardScan ( &boards[ i ] );
+        }
+
+        if ( count > 2 ) {
+            mediumUpdate ( boards, count, run->now );
+        } else {
+            channelUpdate ( &boards[ 0 ], &boards[ 1 ], run->now );
+            channelUpdate ( &boards[ 1 ], &boards[ 0 ], run->now );
+        }
+        run->now += TICK_NS;
+    }
+}
@@ -0,0 +1,215 @@
+/**
+* @file     board.h
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Header file for board.c of the host simulation of the interactive memory game - virtual boards
+*/
+
+#ifndef BOARD_H
+#define BOARD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "display.h"
+#include "game.h"
+
+#define BYTE_NS ( 10 * 1000000000ULL / 2400 ) // start, 8 data and stop bits at 2400 baud
+#define TICK_NS ( 1000000000ULL / PACER_RATE )
+#define NAV_HOLD 30 // navswitch samples a push is held down for
+#define PLAYER_DELAY 120 // ms between a player's pushes in boardsRun ()
+
+
+/**
+ * State of one board's stand-in drivers. The drivers work on whichever
+ * board the calling thread last selected, so each thread can run boards.
+ */
+typedef struct {
+    bool ledState;
+    uint8_t navPending, navDown, navHold;
+    char description[ 32 ];
+    uint8_t frame[ DISPLAY_WIDTH ];
+} hal_t;
+
+
+/**
+ * One board's output to the infra-red channel, and the bytes it has
+ * sent and lost to collisions. Each byte is also lost with a chance of
+ * lossPerMille, drawn from seed.
+ */
+typedef struct {
+    bool inFlight, collided;
+    uint8_t byte;
+    uint64_t busyUntil;
+    unsigned lossPerMille;
+    uint32_t seed;
+    unsigned long bytes, collisions, lost;
+} channel_t;
+
+
+/**
+ * A virtual board: its drivers, its game, its infra-red output, the
+ * parts of a matrix scan, a navswitch sample interrupt and a pass of
+ * the game loop due carried between ticks, the file its game's log is
+ * recorded to, if any, and the file every byte it transmits is
+ * captured to, if any
+ */
+typedef struct {
+    hal_t hal;
+    game_t game;
+    channel_t out;
+    uint16_t scanCarry, sampleCarry, loopCarry;
+    FILE *log;
+    FILE *capture;
+} board_t;
+
+
+/**
+ * A run of boards played by boardsRun () for a number of virtual
+ * minutes or, for a pair with untilWon, until the RECEIVER wins. Its
+ * players push at random monkeyPercent of the time, drawing from seed.
+ * The hooks, if any, are called with the context around each pass of a
+ * board's game loop, with now the time of the tick.
+ */
+typedef struct board_run_s {
+    unsigned minutes;
+    uint8_t monkeyPercent;
+    bool untilWon;
+    uint32_t seed;
+    uint64_t now;
+    void ( *before ) ( struct board_run_s *run, board_t *board, int index );
+    void ( *after ) ( struct board_run_s *run, board_t *board, int index );
+    void *context;
+} board_run_t;
+
+
+/**
+ * Selects the board the calling thread's driver calls work on
+ */
+void halSelect ( hal_t *hal );
+
+
+/**
+ * Initialiser for a board and its game
+ */
+void boardInit ( board_t *board );
+
+
+/**
+ * Runs the navswitch sample interrupts that would have fallen in a
+ * tick's pacer wait, and returns true if the wait ends in a pass of the
+ * board's game loop, at the rate it is paced at
+ */
+bool boardWait ( board_t *board );
+
+
+/**
+ * Runs the matrix scan interrupts that would have fallen in a tick
+ */
+void boardScan ( board_t *board );
+
+
+/**
+ * Runs one PACER_RATE tick of a board, with a pass of its game loop if
+ * one falls due at the board's own pacer rate
+ */
+void boardTick ( board_t *board );
+
+
+/**
+ * Starts recording a board's game, before its first tick, to a log file
+ * named by a prefix and the board's letter, as "prefix.a". Returns false
+ * if the file cannot be written.
+ */
+bool boardRecord ( board_t *board, const char *prefix, char letter );
+
+
+/**
+ * Ends a board's log with the digest of its game play, and closes it.
+ * Returns false if the file could not be written.
+ */
+bool boardRecordEnd ( board_t *board );
+
+
+/**
+ * Starts streaming a board's game log over infra-red, before its first
+ * tick, as a board built with RECORD does, and captures every byte it
+ * transmits to a file, as an infra-red receiver by it would. Returns
+ * false if the file cannot be written.
+ */
+bool boardStream ( board_t *board, const char *path );
+
+
+/**
+ * Ends a board's streamed log with the digest of its game play, as a
+ * push of its button does, captures the rest of its transmission, and
+ * closes the capture. Returns false if it could not be written.
+ */
+bool boardStreamEnd ( board_t *board );
+
+
+/**
+ * Returns a digest of a board's game play, as playDigest () takes it
+ */
+uint32_t boardDigest ( const board_t *board );
+
+
+/**
+ * Queues a navswitch push for the board's next navswitch sample
+ */
+void boardNavPush ( board_t *board, uint8_t navswitch );
+
+
+/**
+ * Returns whether the board's LED is on
+ */
+bool boardLed ( const board_t *board );
+
+
+/**
+ * Describes what the board is displaying: a quoted scrolling string,
+ * a char in single quotes, or an empty string for nothing
+ */
+const char *boardDisplay ( board_t *board );
+
+
+/**
+ * Moves bytes along one direction of the infra-red channel. A byte is
+ * taken from the sender's queue when the wire is free and delivered to
+ * the peer one byte time later, unless lost.
+ */
+void channelUpdate ( board_t *from, board_t *to, uint64_t now );
+
+
+/**
+ * Moves bytes across an infra-red channel shared by a number of boards.
+ * A byte taken from a board's queue reaches every other board one byte
+ * time later, unless another board's byte was on the channel at the
+ * same time, in which case both are lost, or it is lost anyway.
+ */
+void mediumUpdate ( board_t *boards, int count, uint64_t now );
+
+
+/**
+ * Returns the next number of a small xorshift generator, and steps its
+ * seed on
+ */
+uint32_t boardRandom ( uint32_t *seed );
+
+
+/**
+ * A player: pushes the navswitch at random a percentage of the time,
+ * and otherwise repeats the directions it was shown, enters random
+ * ones, raises the difficulty now and then and pushes wherever the game
+ * awaits a push
+ */
+void boardPlay ( board_t *board, uint8_t monkeyPercent, uint32_t *seed );
+
+
+/**
+ * Initialises a number of boards, as a tournament if there are more
+ * than two, and plays them as a run sets out, each pushed by a player
+ * every PLAYER_DELAY ms
+ */
+void boardsRun ( board_t *boards, int count, board_run_t *run );
+#endif
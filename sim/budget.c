@@ -0,0 +1,125 @@
+/**
+* @file     budget.c
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Host check of the interactive memory game - worst case work per pacer tick
+*
+* The game is built with -finstrument-functions, so every call of one of
+* its functions, inlined or not, is counted, and the work of a pass of
+* the game loop is taken as the calls made by gameTick (). Interrupt
+* work, the navswitch samples and matrix scans, falls outside it. Boards
+* are played by players that mostly play sensibly but also push at
+* random. The most a pass does is take a press that changes state,
+* rendering the new state's scroll, with its infra-red receive ring
+* full, as after a stalled pass. So the ring is filled with random bytes
+* before some of the passes that take a press. A pair plays
+* for PAIR_MINUTES, then a tournament of three for TOURNAMENT_MINUTES,
+* so that every state is passed through. The most calls any pass made
+* in each state are listed, and the check fails if any state was never
+* reached or any pass went over TICK_BUDGET calls.
+*
+* Usage: budget
+*/
+
+#include "board.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TICK_BUDGET 600 // calls a pass may make; a state change rendering its scroll with a full ring to parse makes under 560
+#define PAIR_MINUTES 30
+#define TOURNAMENT_MINUTES 30
+#define TOURNAMENT_BOARDS 3
+#define MONKEY_PERCENT 10 // pushes made at random
+#define FLOOD_PERCENT 25 // passes taking a press that a flood of random bytes comes before
+
+void __cyg_profile_func_enter ( void *function, void *caller );
+void __cyg_profile_func_exit ( void *function, void *caller );
+
+static unsigned long calls, passCalls;
+static uint8_t passState;
+static unsigned long passes[ STATE_COUNT ], most[ STATE_COUNT ], total[ STATE_COUNT ];
+
+/**
+ * Counts a call of an instrumented function
+ */
+void __cyg_profile_func_enter ( void *function, void *caller ) {
+    ( void ) function;
+    ( void ) caller;
+    calls++;
+}
+
+/**
+ * Nothing is counted on return
+ */
+void __cyg_profile_func_exit ( void *function, void *caller ) {
+    ( void ) function;
+    ( void ) caller;
+}
+
+/**
+ * Fills a board's receive ring with random bytes
+ */
+static void boardFlood ( board_t *board, uint32_t *seed ) {
+    while ( ringCount ( &board->game.ir.rx ) < RING_SIZE - 1 ) {
+        irReceiveByte ( &board->game.ir, boardRandom ( seed ) );
+    }
+}
+
+/**
+ * Before a pass of a board's game loop: floods some of the passes with
+ * a press to take, and notes the calls so far and the state the pass
+ * starts in
+ */
+static void passBefore ( board_run_t *run, board_t *board, int index ) {
+    input_t *input = &board->game.input;
+
+    ( void ) index;
+
+    if ( ( input->head != input->tail ) && ( boardRandom ( &run->seed ) % 100 < FLOOD_PERCENT ) ) {
+        boardFlood ( board, &run->seed );
+    }
+    passState = board->game.state;
+    passCalls = calls;
+}
+
+/**
+ * After a pass of a board's game loop: counts the calls it made against
+ * the state it started in
+ */
+static void passAfter ( board_run_t *run, board_t *board, int index ) {
+    unsigned long made = calls - passCalls;
+
+    ( void ) run;
+    ( void ) board;
+    ( void ) index;
+    passes[ passState ]++;
+    total[ passState ] += made;
+
+    if ( made > most[ passState ] ) {
+        most[ passState ] = made;
+    }
+}
+
+int main ( void ) {
+    static board_t boards[ TOURNAMENT_BOARDS ];
+    board_run_t pair = { PAIR_MINUTES, MONKEY_PERCENT, false, 2463534242UL, 0, passBefore, passAfter, 0 };
+    board_run_t tournament = { TOURNAMENT_MINUTES, MONKEY_PERCENT, false, 88172645UL, 0, passBefore, passAfter, 0 };
+    unsigned long worst = 0;
+    uint8_t state;
+    bool passed = true;
+
+    boardsRun ( boards, 2, &pair );
+    boardsRun ( boards, TOURNAMENT_BOARDS, &tournament );
+
+    printf ( "state  passes      mean calls  most calls\n" );
+
+    for ( state = 0; state < STATE_COUNT; state++ ) {
+        printf ( "%5u  %8lu  %10.1f  %10lu%s\n", state, passes[ state ],
+                 passes[ state ] ? ( double ) total[ state ] / passes[ state ] : 0, most[ state ],
+                 !passes[ state ] ? "  never reached" : most[ state ] > TICK_BUDGET ? "  over budget" : "" );
+        passed = passed && passes[ state ] && ( most[ state ] <= TICK_BUDGET );
+        worst = most[ state ] > worst ? most[ state ] : worst;
+    }
+    printf ( "budget: most calls in a pass %lu, budget %u, %s\n", worst, TICK_BUDGET, passed ? "passed" : "FAILED" );
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
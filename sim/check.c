@@ -0,0 +1,40 @@
+/**
+* @file     check.c
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Host checks of the interactive memory game - failed check counting
+*
+* Every host check counts and reports its failures the same way, one
+* line each as "FAIL  what where: value", and exits non-zero if any.
+*/
+
+#include "check.h"
+#include <stdio.h>
+
+static char where[ 32 ];
+static unsigned failures;
+
+/**
+ * Names where the checks that follow are made, such as "at 300 Hz",
+ * reported with any of them that fails, or 0 for nowhere in particular
+ */
+void checkWhere ( const char *name ) {
+    snprintf ( where, sizeof ( where ), "%s%s", name ? " " : "", name ? name : "" );
+}
+
+/**
+ * Counts and reports a failed check, with the value that failed it
+ */
+void check ( bool ok, const char *what, unsigned long value ) {
+    if ( !ok ) {
+        printf ( "FAIL  %s%s: %lu\n", what, where, value );
+        failures++;
+    }
+}
+
+/**
+ * Returns the number of checks failed so far
+ */
+unsigned checkFailures ( void ) {
+    return failures;
+}
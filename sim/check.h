@@ -0,0 +1,31 @@
+/**
+* @file     check.h
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Header file for check.c of the host checks of the interactive memory game - failed check counting
+*/
+
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <stdbool.h>
+
+
+/**
+ * Names where the checks that follow are made, such as "at 300 Hz",
+ * reported with any of them that fails, or 0 for nowhere in particular
+ */
+void checkWhere ( const char *where );
+
+
+/**
+ * Counts and reports a failed check, with the value that failed it
+ */
+void check ( bool ok, const char *what, unsigned long value );
+
+
+/**
+ * Returns the number of checks failed so far
+ */
+unsigned checkFailures ( void );
+#endif
@@ -0,0 +1,168 @@
+/**
+* @file     draw.c
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Host benchmark of the interactive memory game - drawing chars through disp.c
+*
+* Shows every glyph of glyphs5x7 as a static char through disp.c, with
+* displayChar () and displayFrame (), and reads the frame back through
+* matrixScan () as the LED matrix is lit. Each frame must be the char
+* drawn a pixel at a time from the stand-in font5x7_1 with
+* font_pixel_get (), as static chars were drawn before, so the check
+* covers tools/fontsub's pre-rendering of the columns as well as
+* disp.c. 'A', 'B' and 'C' must be shown as the digits they stand for.
+* Every glyph of glyphs3x5 is then shown as a string of one char with
+* displayString (), and its first frame must be the char drawn from
+* font3x5_1 turned to read down the display. Last, each way of drawing
+* a static char is timed over DRAWS draws and the mean time per draw
+* printed; host times only show the ratio, as the AVR's variable shifts
+* make the pixel at a time draw relatively slower still.
+*
+* Usage: draw
+*/
+
+#include "board.h"
+#include "font3x5_1.h"
+#include "font5x7_1.h"
+#include "glyphs3x5.h"
+#include "glyphs5x7.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DRAWS 2000000UL
+#define SCROLL_ROWS 3 // a scroll glyph's columns, each a display row
+
+static hal_t hal;
+static disp_t disp;
+static unsigned failures;
+
+/**
+ * Draws a char a pixel at a time from font5x7_1
+ */
+static void pixelDraw ( uint8_t *frame, char ch ) {
+    uint8_t x, y;
+
+    for ( x = 0; x < DISPLAY_WIDTH; x++ ) {
+        frame[ x ] = 0;
+
+        for ( y = 0; y < DISPLAY_HEIGHT; y++ ) {
+            if ( font_pixel_get ( &font5x7_1, ch, x, y ) ) {
+                frame[ x ] |= 1 << y;
+            }
+        }
+    }
+}
+
+/**
+ * Reads the frame disp.c drew back from a scan of every column
+ */
+static void frameScan ( uint8_t *frame ) {
+    uint8_t x, column, pattern;
+
+    for ( x = 0; x < DISPLAY_WIDTH; x++ ) {
+        pattern = matrixScan ( &disp.matrix, &column );
+        frame[ column ] = pattern;
+    }
+}
+
+/**
+ * Draws a char through disp.c, as the game shows a static char, and
+ * reads the frame back
+ */
+static void displayDraw ( uint8_t *frame, char ch ) {
+    displayChar ( &disp, &ch );
+    displayFrame ( &disp );
+    frameScan ( frame );
+}
+
+/**
+ * Checks a static char is shown as another char is drawn from the font
+ */
+static void staticCheck ( char ch, char drawn ) {
+    uint8_t expected[ DISPLAY_WIDTH ], shown[ DISPLAY_WIDTH ];
+
+    pixelDraw ( expected, drawn );
+    displayDraw ( shown, ch );
+
+    if ( memcmp ( expected, shown, DISPLAY_WIDTH ) ) {
+        printf ( "FAIL  '%c' shown differently from font5x7_1's '%c'\n", ch, drawn );
+        failures++;
+    }
+}
+
+/**
+ * Checks the first frame of a one char scrolling string: each column of
+ * the char's glyph down the display, last row at the left
+ */
+static void scrollCheck ( const char *string ) {
+    uint8_t expected[ DISPLAY_WIDTH ] = { 0 }, shown[ DISPLAY_WIDTH ];
+    uint8_t x, y;
+
+    for ( y = 0; y < SCROLL_ROWS; y++ ) {
+        for ( x = 0; x < DISPLAY_WIDTH; x++ ) {
+            if ( font_pixel_get ( &font3x5_1, string[ 0 ], y, x ) ) {
+                expected[ DISPLAY_WIDTH - 1 - x ] |= 1 << y;
+            }
+        }
+    }
+    displayString ( &disp, string );
+    displayFrame ( &disp );
+    frameScan ( shown );
+
+    if ( memcmp ( expected, shown, DISPLAY_WIDTH ) ) {
+        printf ( "FAIL  '%c' scrolls differently from font3x5_1\n", string[ 0 ] );
+        failures++;
+    }
+}
+
+/**
+ * Times a way of drawing over every static glyph in turn, returning the
+ * mean ns per draw
+ */
+static double drawTime ( void ( *draw ) ( uint8_t *frame, char ch ) ) {
+    static volatile uint8_t sink;
+    uint8_t frame[ DISPLAY_WIDTH ];
+    unsigned long i;
+    clock_t start = clock ();
+
+    for ( i = 0; i < DRAWS; i++ ) {
+        draw ( frame, glyphs5x7Chars[ i % glyphs5x7.count ] );
+        sink ^= frame[ i % DISPLAY_WIDTH ];
+    }
+    return ( double ) ( clock () - start ) / CLOCKS_PER_SEC * 1e9 / DRAWS;
+}
+
+int main ( void ) {
+    static char strings[ sizeof ( glyphs3x5Chars ) ][ 2 ];
+    double pixelTime, displayTime;
+    uint8_t i;
+
+    halSelect ( &hal );
+    displayInit ( &disp, PACER_RATE );
+
+    for ( i = 0; i < glyphs5x7.count; i++ ) {
+        staticCheck ( glyphs5x7Chars[ i ], glyphs5x7Chars[ i ] );
+    }
+    staticCheck ( 'A', '1' );
+    staticCheck ( 'B', '2' );
+    staticCheck ( 'C', '3' );
+
+    for ( i = 0; i < glyphs3x5.count; i++ ) {
+        strings[ i ][ 0 ] = glyphs3x5Chars[ i ];
+        scrollCheck ( strings[ i ] );
+    }
+    pixelTime = drawTime ( pixelDraw );
+    displayTime = drawTime ( displayDraw );
+    printf ( "static char draw, mean of %lu: font pixels %.1f ns, displayChar and displayFrame %.1f ns, %.1fx faster\n",
+             DRAWS, pixelTime, displayTime, displayTime > 0 ? pixelTime / displayTime : 0 );
+
+    if ( failures ) {
+        printf ( "draw: %u chars shown differently\n", failures );
+        return EXIT_FAILURE;
+    }
+    printf ( "draw: all %u static and %u scroll glyphs shown as the fonts draw them\n", glyphs5x7.count,
+             glyphs3x5.count );
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,44 @@
+/**
+* @file     font3x5_1.h
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Host simulation stand-in for the UCFK4 3x5 font; its geometry, with glyphs for the chars the game draws and the rest blank
+*/
+
+#ifndef FONT3X5_1_H
+#define FONT3X5_1_H
+
+#include "font.h"
+
+/**
+ * Each glyph's pixels a row at a time from the top, left to right, low
+ * bit first, as font_pixel_get () reads them
+ */
+static font_t font3x5_1 = { 1, 3, 5, 32, 96, 2, {
+    [ ( '!' - 32 ) * 2 ] = 0x92, 0x20,
+    [ ( '-' - 32 ) * 2 ] = 0xc0, 0x01,
+    [ ( '1' - 32 ) * 2 ] = 0x9a, 0x74,
+    [ ( '3' - 32 ) * 2 ] = 0xa3, 0x38,
+    [ ( 'A' - 32 ) * 2 ] = 0xea, 0x5b,
+    [ ( 'C' - 32 ) * 2 ] = 0x4e, 0x62,
+    [ ( 'D' - 32 ) * 2 ] = 0x6b, 0x3b,
+    [ ( 'E' - 32 ) * 2 ] = 0xcf, 0x72,
+    [ ( 'F' - 32 ) * 2 ] = 0xcf, 0x12,
+    [ ( 'G' - 32 ) * 2 ] = 0x4e, 0x6b,
+    [ ( 'H' - 32 ) * 2 ] = 0xed, 0x5b,
+    [ ( 'I' - 32 ) * 2 ] = 0x97, 0x74,
+    [ ( 'L' - 32 ) * 2 ] = 0x49, 0x72,
+    [ ( 'M' - 32 ) * 2 ] = 0xfd, 0x5b,
+    [ ( 'N' - 32 ) * 2 ] = 0x6b, 0x5b,
+    [ ( 'O' - 32 ) * 2 ] = 0x6a, 0x2b,
+    [ ( 'P' - 32 ) * 2 ] = 0xeb, 0x12,
+    [ ( 'R' - 32 ) * 2 ] = 0xeb, 0x5a,
+    [ ( 'S' - 32 ) * 2 ] = 0x8e, 0x38,
+    [ ( 'T' - 32 ) * 2 ] = 0x97, 0x24,
+    [ ( 'U' - 32 ) * 2 ] = 0x6d, 0x7b,
+    [ ( 'V' - 32 ) * 2 ] = 0x6d, 0x2b,
+    [ ( 'W' - 32 ) * 2 ] = 0xed, 0x5f,
+    [ ( 'Y' - 32 ) * 2 ] = 0xad, 0x24,
+    [ 96 * 2 - 1 ] = 0
+} };
+#endif
@@ -0,0 +1,37 @@
+/**
+* @file     font5x7_1.h
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Host simulation stand-in for the UCFK4 5x7 font; its geometry, with glyphs for the chars the game draws and the rest blank
+*/
+
+#ifndef FONT5X7_1_H
+#define FONT5X7_1_H
+
+#include "font.h"
+
+/**
+ * Each glyph's pixels a row at a time from the top, left to right, low
+ * bit first, as font_pixel_get () reads them
+ */
+static font_t font5x7_1 = { 1, 5, 7, 32, 96, 5, {
+    [ ( '$' - 32 ) * 5 ] = 0xc4, 0x17, 0x47, 0x1f, 0x01,
+    [ ( '*' - 32 ) * 5 ] = 0x80, 0x54, 0x57, 0x09, 0x00,
+    [ ( '-' - 32 ) * 5 ] = 0x00, 0x80, 0x0f, 0x00, 0x00,
+    [ ( '1' - 32 ) * 5 ] = 0xc4, 0x10, 0x42, 0x88, 0x03,
+    [ ( '2' - 32 ) * 5 ] = 0x2e, 0x42, 0x44, 0xc4, 0x07,
+    [ ( '3' - 32 ) * 5 ] = 0x1f, 0x11, 0x04, 0xa3, 0x03,
+    [ ( '4' - 32 ) * 5 ] = 0x88, 0xa9, 0xf4, 0x11, 0x02,
+    [ ( '5' - 32 ) * 5 ] = 0x3f, 0x3c, 0x08, 0xa3, 0x03,
+    [ ( '6' - 32 ) * 5 ] = 0x4c, 0x84, 0x17, 0xa3, 0x03,
+    [ ( '7' - 32 ) * 5 ] = 0x1f, 0x22, 0x22, 0x84, 0x00,
+    [ ( '8' - 32 ) * 5 ] = 0x2e, 0x46, 0x17, 0xa3, 0x03,
+    [ ( 'E' - 32 ) * 5 ] = 0x3f, 0x84, 0x17, 0xc2, 0x07,
+    [ ( 'N' - 32 ) * 5 ] = 0x31, 0xce, 0x9a, 0x63, 0x04,
+    [ ( 'R' - 32 ) * 5 ] = 0x2f, 0xc6, 0x57, 0x52, 0x04,
+    [ ( 'S' - 32 ) * 5 ] = 0x3e, 0x04, 0x07, 0xe1, 0x03,
+    [ ( 'W' - 32 ) * 5 ] = 0x31, 0xc6, 0x5a, 0xab, 0x02,
+    [ ( 'X' - 32 ) * 5 ] = 0x31, 0x2a, 0xa2, 0x62, 0x04,
+    [ 96 * 5 - 1 ] = 0
+} };
+#endif
@@ -0,0 +1,126 @@
+/**
+* @file     hal.c
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Host simulation stand-ins for the UCFK4 drivers of the virtual boards
+*
+* The stand-ins keep their state in the hal_t of the board the calling
+* thread last selected. A push queued by the simulation holds its switch
+* down from the next navswitch_update () for NAV_HOLD samples, and the display's pixels and the LED are
+* kept for the simulation to read back. font_pixel_get () reads the stand-in fonts in sim/fonts.
+*/
+
+#include "system.h"
+#include "pio.h"
+#include "led.h"
+#include "ir_uart.h"
+#include "navswitch.h"
+#include "display.h"
+#include "ledmat.h"
+#include "button.h"
+#include "font.h"
+#include "board.h"
+
+static _Thread_local hal_t *hal;
+
+/**
+ * Selects the board the calling thread's driver calls work on
+ */
+void halSelect ( hal_t *board ) {
+    hal = board;
+}
+
+void system_init ( void ) {
+}
+
+bool pio_config_set ( pio_t pio, pio_config_t config ) {
+    if ( pio == LED1_PIO ) {
+        hal->ledState = config == PIO_OUTPUT_HIGH;
+    }
+    return true;
+}
+
+void pio_output_high ( pio_t pio ) {
+    pio_config_set ( pio, PIO_OUTPUT_HIGH );
+}
+
+void pio_output_low ( pio_t pio ) {
+    pio_config_set ( pio, PIO_OUTPUT_LOW );
+}
+
+void pio_output_toggle ( pio_t pio ) {
+    if ( pio == LED1_PIO ) {
+        hal->ledState = !hal->ledState;
+    }
+}
+
+bool pio_input_get ( pio_t pio ) {
+    return pio == LED1_PIO && hal->ledState;
+}
+
+void led_init ( void ) {
+    hal->ledState = false;
+}
+
+void led_set ( uint8_t led, bool state ) {
+    if ( led == LED1 ) {
+        hal->ledState = state;
+    }
+}
+
+int8_t ir_uart_init ( void ) {
+    return 1;
+}
+
+void navswitch_init ( void ) {
+    hal->navPending = 0;
+    hal->navDown = 0;
+    hal->navHold = 0;
+}
+
+void navswitch_update ( void ) {
+    if ( hal->navPending ) {
+        hal->navDown = hal->navPending;
+        hal->navPending = 0;
+        hal->navHold = NAV_HOLD;
+    } else if ( hal->navHold && !--hal->navHold ) {
+        hal->navDown = 0;
+    }
+}
+
+bool navswitch_down_p ( uint8_t navswitch ) {
+    return hal->navDown & ( 1 << navswitch );
+}
+
+void button_init ( void ) {
+}
+
+void button_update ( void ) {
+}
+
+bool button_push_event_p ( uint8_t button ) {
+    ( void ) button;
+    return false;
+}
+
+void ledmat_init ( void ) {
+    uint8_t col;
+
+    for ( col = 0; col < DISPLAY_WIDTH; col++ ) {
+        hal->frame[ col ] = 0;
+    }
+}
+
+void ledmat_display_column ( uint8_t pattern, uint8_t col ) {
+    hal->frame[ col ] = pattern;
+}
+
+bool font_pixel_get ( font_t *font, char ch, uint8_t col, uint8_t row ) {
+    uint8_t index = ch - font->offset;
+    uint16_t bit = row * font->width + col;
+
+    if ( ( index >= font->size ) || ( col >= font->width ) || ( row >= font->height ) ) {
+        return false;
+    }
+    return font->data[ index * font->bytes + bit / 8 ] & ( 1 << ( bit % 8 ) );
+}
@@ -0,0 +1,21 @@
+/**
+* @file     button.h
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Host simulation stand-in for the UCFK4 button driver; the button is never pushed
+*/
+
+#ifndef BUTTON_H
+#define BUTTON_H
+
+#include "system.h"
+
+#define BUTTON1 0
+
+
+void button_init ( void );
+
+void button_update ( void );
+
+bool button_push_event_p ( uint8_t button );
+#endif
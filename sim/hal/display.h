@@ -0,0 +1,15 @@
+/**
+* @file     display.h
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Host simulation stand-in for the UCFK4 display driver; its dimensions only
+*/
+
+#ifndef DISPLAY_H
+#define DISPLAY_H
+
+#include "system.h"
+
+#define DISPLAY_WIDTH 5
+#define DISPLAY_HEIGHT 7
+#endif
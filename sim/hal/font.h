@@ -0,0 +1,25 @@
+/**
+* @file     font.h
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Host simulation stand-in for the UCFK4 font utility
+*/
+
+#ifndef FONT_H
+#define FONT_H
+
+#include "system.h"
+
+typedef struct {
+    uint8_t flags;
+    uint8_t width;
+    uint8_t height;
+    uint8_t offset;
+    uint8_t size;
+    uint8_t bytes;
+    uint8_t data[];
+} font_t;
+
+
+bool font_pixel_get ( font_t *font, char ch, uint8_t col, uint8_t row );
+#endif
@@ -0,0 +1,20 @@
+/**
+* @file     ir_uart.h
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Host simulation stand-in for the UCFK4 infra-red UART driver
+*
+* Bytes reach the wire through ir.c's queues, which the simulation
+* drains and fills, so only the initialiser is needed.
+*/
+
+#ifndef IR_UART_H
+#define IR_UART_H
+
+#include "system.h"
+
+#define IR_UART_BAUD_RATE 2400
+
+
+int8_t ir_uart_init ( void );
+#endif
@@ -0,0 +1,19 @@
+/**
+* @file     led.h
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Host simulation stand-in for the UCFK4 LED driver
+*/
+
+#ifndef LED_H
+#define LED_H
+
+#include "system.h"
+
+#define LED1 0
+
+
+void led_init ( void );
+
+void led_set ( uint8_t led, bool state );
+#endif
@@ -0,0 +1,17 @@
+/**
+* @file     ledmat.h
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Host simulation stand-in for the UCFK4 LED matrix driver
+*/
+
+#ifndef LEDMAT_H
+#define LEDMAT_H
+
+#include "system.h"
+
+
+void ledmat_init ( void );
+
+void ledmat_display_column ( uint8_t pattern, uint8_t col );
+#endif
@@ -0,0 +1,28 @@
+/**
+* @file     navswitch.h
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Host simulation stand-in for the UCFK4 navswitch driver
+*/
+
+#ifndef NAVSWITCH_H
+#define NAVSWITCH_H
+
+#include "system.h"
+
+enum {
+    NAVSWITCH_NORTH,
+    NAVSWITCH_EAST,
+    NAVSWITCH_SOUTH,
+    NAVSWITCH_WEST,
+    NAVSWITCH_PUSH,
+    NAVSWITCH_NUM
+};
+
+
+void navswitch_init ( void );
+
+void navswitch_update ( void );
+
+bool navswitch_down_p ( uint8_t navswitch );
+#endif
@@ -0,0 +1,34 @@
+/**
+* @file     pio.h
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Host simulation stand-in for the UCFK4 PIO driver; only the LED pin exists
+*/
+
+#ifndef PIO_H
+#define PIO_H
+
+#include "system.h"
+
+#define LED1_PIO 0
+
+typedef uint8_t pio_t;
+
+typedef enum {
+    PIO_INPUT,
+    PIO_PULLUP,
+    PIO_OUTPUT_LOW,
+    PIO_OUTPUT_HIGH
+} pio_config_t;
+
+
+bool pio_config_set ( pio_t pio, pio_config_t config );
+
+void pio_output_high ( pio_t pio );
+
+void pio_output_low ( pio_t pio );
+
+void pio_output_toggle ( pio_t pio );
+
+bool pio_input_get ( pio_t pio );
+#endif
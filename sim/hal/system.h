@@ -0,0 +1,18 @@
+/**
+* @file     system.h
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Host simulation stand-in for the UCFK4 system driver
+*/
+
+#ifndef SYSTEM_H
+#define SYSTEM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define F_CPU 8000000
+
+
+void system_init ( void );
+#endif
@@ -0,0 +1,252 @@
+/**
+* @file     loopback.c
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Host check of the interactive memory game - infra-red frames looped back, and their bytes and round trips
+*
+* First loops frames of every payload length back through a board's
+* transmission and reception queues, a byte at a time as the UART
+* interrupts move them, and checks each arrives once and whole, that a
+* frame with any one bit flipped or cut short is rejected, and that
+* frames are found again after it: a damaged frame can take the bytes
+* of the next for its own, so the next is sent again, as the link
+* retransmits, and must be found within RESUME_COPIES copies. Then two
+* boards play a whole game over the virtual channel, and for each level
+* the bytes crossing the channel and the round trips taken while the
+* SENDER transmits its directions are counted, against the stop-and-wait
+* protocol the framing replaced, which sent each direction as one byte
+* and waited for it to be echoed: two bytes and a round trip per
+* direction. Exits non-zero on a failure.
+*
+* Usage: loopback
+*/
+
+#include "board.h"
+#include "check.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PLAYER_DELAY 120 // ms between a player's pushes
+#define GAME_MINUTES 5 // a whole game takes well under this
+#define LEVELS_MAX 8
+#define RESUME_COPIES ( ( FRAME_OVERHEAD + FRAME_PAYLOAD_MAX ) / ( FRAME_OVERHEAD + LINK_ACK_PAYLOAD ) + 2 )
+
+/**
+ * The bytes and round trips one level's directions took
+ */
+typedef struct {
+    uint8_t directions;
+    unsigned long bytes, roundTrips;
+} level_t;
+
+/**
+ * Moves every queued byte of a board's transmission queue to its own
+ * reception queue, flipping the bits of one of them in a mask, and
+ * passes each recepted byte to a parser. Returns the good frames found.
+ */
+static unsigned loopBytes ( ir_t *ir, frame_parser_t *parser, unsigned flip, uint8_t mask, frame_t *found ) {
+    unsigned frames = 0, index = 0;
+    uint8_t byte;
+
+    while ( irTransmitByte ( ir, &byte ) ) {
+        irReceiveByte ( ir, index++ == flip ? byte ^ mask : byte );
+
+        while ( irReadReady ( ir ) ) {
+            if ( frameReceive ( parser, irGetc ( ir ) ) ) {
+                *found = parser->frame;
+                frames++;
+            }
+        }
+    }
+    return frames;
+}
+
+/**
+ * Sends a good frame again and again, as the link would retransmit it,
+ * and checks it is found within RESUME_COPIES copies
+ */
+static void resumeCheck ( ir_t *ir, frame_parser_t *parser, const char *what, unsigned long value ) {
+    static const uint8_t payload[ LINK_ACK_PAYLOAD ] = { 1, 2 };
+    frame_t found;
+    uint8_t copies;
+
+    for ( copies = 0; copies < RESUME_COPIES; copies++ ) {
+        frameSend ( ir, FRAME_ACK, 1, payload, LINK_ACK_PAYLOAD );
+
+        if ( loopBytes ( ir, parser, ~0U, 0, &found ) ) {
+            check ( found.type == FRAME_ACK, what, value );
+            return;
+        }
+    }
+    check ( false, what, value );
+}
+
+/**
+ * Sends a frame with a payload of a length, a bit of it flipped or not,
+ * followed by a good frame, and checks what is recepted
+ */
+static void frameCheck ( uint8_t length, unsigned flip, uint8_t mask ) {
+    ir_t ir;
+    frame_parser_t parser;
+    frame_t found;
+    uint8_t payload[ FRAME_PAYLOAD_MAX ], i;
+    unsigned frames;
+
+    irInit ( &ir );
+    frameReset ( &parser );
+
+    for ( i = 0; i < length; i++ ) {
+        payload[ i ] = ( uint8_t ) ( i * 37 + length );
+    }
+    frameSend ( &ir, FRAME_DIRECTIONS, length, payload, length );
+    check ( ringCount ( &ir.tx ) == FRAME_OVERHEAD + length, "frame of wrong size queued", length );
+    frames = loopBytes ( &ir, &parser, flip, mask, &found );
+
+    if ( !mask ) {
+        check ( frames == 1, "good frame not recepted once", length );
+        check ( ( found.type == FRAME_DIRECTIONS ) && ( found.sequence == length ) && ( found.length == length )
+                && !memcmp ( found.payload, payload, length ), "frame recepted changed", length );
+    } else {
+        check ( frames == 0, "damaged frame accepted", length * 100UL + flip );
+    }
+    resumeCheck ( &ir, &parser, "frames not found after a damaged one", length * 100UL + flip );
+}
+
+/**
+ * Sends a frame with its last bytes cut off, checks it is rejected and
+ * that frames are found again after it
+ */
+static void truncatedCheck ( uint8_t length, uint8_t cut ) {
+    ir_t ir;
+    frame_parser_t parser;
+    uint8_t payload[ FRAME_PAYLOAD_MAX ] = { 0 }, byte;
+    unsigned frames = 0;
+
+    irInit ( &ir );
+    frameReset ( &parser );
+    frameSend ( &ir, FRAME_DIRECTIONS, 0, payload, length );
+
+    while ( ( ringCount ( &ir.tx ) > cut ) && irTransmitByte ( &ir, &byte ) ) {
+        frames += frameReceive ( &parser, byte );
+    }
+    ringInit ( &ir.tx );
+    check ( frames == 0, "frame cut short accepted", length * 100UL + cut );
+    resumeCheck ( &ir, &parser, "frames not found after one cut short", length * 100UL + cut );
+}
+
+/**
+ * A player: pushes wherever the game awaits a push, enters directions
+ * in turn as SENDER and repeats them correctly as RECEIVER
+ */
+static void playerPlay ( board_t *board, uint8_t *entered ) {
+    static const char directions[] = "NESW";
+    game_t *game = &board->game;
+    uint8_t navswitch = NAVSWITCH_PUSH;
+
+    if ( game->state == STATE_RECEIVER_REPEAT ) {
+        navswitch = strchr ( directions, directionsGet ( &game->directions, game->attemptCount ) ) - directions;
+    } else if ( game->state == STATE_SENDER_DIRECTIONS ) {
+        navswitch = ( *entered )++ % 4;
+    }
+    boardNavPush ( board, navswitch );
+}
+
+/**
+ * Returns the round trips a link has had acknowledged, counting each
+ * retransmission as one more
+ */
+static unsigned long roundTrips ( const link_t *link ) {
+    unsigned long trips = link->stats.retransmissions;
+    uint8_t i;
+
+    for ( i = 0; i < LINK_RTT_BUCKETS; i++ ) {
+        trips += link->stats.rtt[ i ];
+    }
+    return trips;
+}
+
+/**
+ * Plays a whole game between two boards, counting the bytes and round
+ * trips of each level's directions. Returns the levels played.
+ */
+static uint8_t gameMeasure ( level_t *levels ) {
+    static board_t boards[ 2 ];
+    board_t *sender = &boards[ 0 ];
+    unsigned long tick, bytes = 0, trips = 0;
+    uint64_t now = 0;
+    uint8_t entered = 0, played = 0, i;
+    bool transmitting = false;
+
+    boardInit ( &boards[ 0 ] );
+    boardInit ( &boards[ 1 ] );
+
+    for ( tick = 0; ( tick < GAME_MINUTES * 60UL * PACER_RATE )
+          && ( boards[ 1 ].game.state != STATE_RECEIVER_GAME_WON ) && ( played < LEVELS_MAX ); tick++ ) {
+        for ( i = 0; i < 2; i++ ) {
+            if ( ( tick + i * 7 ) % ( PACER_RATE * PLAYER_DELAY / 1000 ) == 0 ) {
+                playerPlay ( &boards[ i ], &entered );
+            }
+            boardTick ( &boards[ i ] );
+        }
+
+        if ( !transmitting && ( sender->game.state == STATE_SENDER_TRANSMIT ) ) {
+            transmitting = true;
+            levels[ played ].directions = sender->game.numberOfDirections;
+            bytes = boards[ 0 ].out.bytes + boards[ 1 ].out.bytes;
+            trips = roundTrips ( &sender->game.link );
+        }
+        channelUpdate ( &boards[ 0 ], &boards[ 1 ], now );
+        channelUpdate ( &boards[ 1 ], &boards[ 0 ], now );
+        now += TICK_NS;
+
+        if ( transmitting && ( sender->game.state != STATE_SENDER_TRANSMIT ) ) {
+            transmitting = false;
+            levels[ played ].bytes = boards[ 0 ].out.bytes + boards[ 1 ].out.bytes - bytes;
+            levels[ played ].roundTrips = roundTrips ( &sender->game.link ) - trips;
+            played++;
+        }
+    }
+    check ( boards[ 1 ].game.state == STATE_RECEIVER_GAME_WON, "game not won", boards[ 1 ].game.state );
+    return played;
+}
+
+int main ( void ) {
+    level_t levels[ LEVELS_MAX ];
+    unsigned flip;
+    uint8_t length, cut, bit, played, i;
+
+    for ( length = 0; length <= FRAME_PAYLOAD_MAX; length++ ) {
+        frameCheck ( length, ~0U, 0 );
+
+        for ( flip = 0; flip < ( unsigned ) FRAME_OVERHEAD + length; flip++ ) {
+            for ( bit = 0; bit < 8; bit++ ) {
+                frameCheck ( length, flip, 1 << bit );
+            }
+        }
+
+        for ( cut = 1; cut < FRAME_OVERHEAD + length; cut++ ) {
+            truncatedCheck ( length, cut );
+        }
+    }
+    printf ( "frames of 0 to %u payload bytes looped back, every one bit flip and cut rejected\n", FRAME_PAYLOAD_MAX );
+
+    played = gameMeasure ( levels );
+    printf ( "level  directions  framed bytes  round trips  stop-and-wait bytes  round trips\n" );
+
+    for ( i = 0; i < played; i++ ) {
+        printf ( "%5u  %10u  %12lu  %11lu  %19u  %11u\n", i + 1, levels[ i ].directions, levels[ i ].bytes,
+                 levels[ i ].roundTrips, 2 * levels[ i ].directions, levels[ i ].directions );
+        check ( levels[ i ].bytes == ( unsigned long ) 2 * FRAME_OVERHEAD + 1
+                + DIRECTIONS_BYTES ( levels[ i ].directions ) + LINK_ACK_PAYLOAD, "directions took extra bytes", i + 1 );
+        check ( levels[ i ].roundTrips == 1, "directions took more than one round trip", i + 1 );
+    }
+    check ( played == 3, "levels played", played );
+
+    if ( checkFailures () ) {
+        printf ( "loopback: %u checks failed\n", checkFailures () );
+        return EXIT_FAILURE;
+    }
+    printf ( "loopback: all checks passed\n" );
+    return EXIT_SUCCESS;
+}
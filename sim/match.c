@@ -0,0 +1,622 @@
+/**
+* @file     match.c
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Host simulation of the interactive memory game - parallel Monte-Carlo matches between bot players
+*
+* A match is one game on its own pair of virtual boards: bot A starts as
+* SENDER at the difficulty the match number picks, and bot B plays
+* RECEIVER until it fails a level or wins the game. Bot B recalls each
+* direction correctly with a chance set by the difficulty, and both bots
+* take a push every BOT_DELAY ms, each with their own seeded generator,
+* so every match plays out the same on any number of threads.
+*
+* Matches are shared out in chunks by a work-stealing pool: each thread
+* takes chunks from the front of its own range of matches, and once that
+* is empty steals the back half of the largest range left. Results are
+* kept as columns, and written with -o as "MATCHES1", the match count
+* as a little-endian uint32, then each column in turn: difficulty
+* (uint8, 1-3), level reached (uint8, 1-3), won (uint8, 0/1, 2 if the
+* match timed out), virtual ticks taken (uint32) and infra-red bytes
+* sent (uint16).
+*
+* With -t, tournaments of 2 to TOURNAMENT_NODES_MAX boards sharing one
+* infra-red channel are instead played by bots for TOURNAMENT_MINUTES
+* virtual minutes each, one tournament per thread, to show how the match
+* rate and channel use change with the number of boards.
+*
+* With -l, two boards instead play on and on for SOAK_MINUTES virtual
+* minutes over a channel losing 0 to SOAK_LOSS_MAX per cent of bytes,
+* one loss rate per thread, to show how many levels a minute the link's
+* retransmissions keep completing, and how long its worst recovery took.
+*
+* With -r, match -m alone is instead played, as it plays in any run,
+* with each board's game recorded for sim/replay to play again.
+*/
+
+#include "board.h"
+#include "navswitch.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BOT_DELAY 100 // ms
+#define MATCH_TIMEOUT ( PACER_RATE * 600 )
+#define CHUNK 64
+#define MAX_THREADS 256
+#define DIFFICULTIES 3
+#define SCALING_MATCHES 20000
+#define TOURNAMENT_MINUTES 60
+#define TOURNAMENT_DIFFICULTY 1 // the middle difficulty
+#define SOAK_MINUTES 60
+#define SOAK_LOSS_STEP 5 // per cent
+#define SOAK_LOSS_MAX 30 // per cent
+#define SOAK_RUNS ( SOAK_LOSS_MAX / SOAK_LOSS_STEP + 1 )
+
+/**
+ * Per-match results, one column per field
+ */
+typedef struct {
+    uint8_t *difficulty;
+    uint8_t *level;
+    uint8_t *won;
+    uint32_t *ticks;
+    uint16_t *bytes;
+} results_t;
+
+/**
+ * The range of matches a worker thread has left to run
+ */
+typedef struct {
+    pthread_mutex_t lock;
+    unsigned long next;
+    unsigned long end;
+    unsigned long stolen;
+} worker_t;
+
+/**
+ * A tournament of a number of boards, and what it achieved
+ */
+typedef struct {
+    int nodes;
+    unsigned long matches, bytes, collisions;
+} tournament_t;
+
+/**
+ * A soak test of two boards over a lossy channel, and what it achieved
+ */
+typedef struct {
+    unsigned lossPerMille;
+    unsigned long levels, lost, retransmissions, duplicates, dropped;
+    uint32_t longestGap;
+    uint16_t longestDelivery;
+} soak_t;
+
+static worker_t workers[ MAX_THREADS ];
+static int workerCount;
+static results_t results;
+static const char *recordPrefix;
+
+static const unsigned recall[ DIFFICULTIES ] = { 985, 970, 940 }; // chance per mille
+
+/**
+ * Converts a direction char to the navswitch direction giving it
+ */
+static uint8_t navFor ( char direction ) {
+    static const char directions[] = "NESW";
+
+    return strchr ( directions, direction ) - directions;
+}
+
+/**
+ * Bot A: starts the game as SENDER, chooses the difficulty, then enters
+ * random directions for each level
+ */
+static void botSender ( board_t *board, char difficulty, uint32_t *seed ) {
+    game_t *game = &board->game;
+
+    if ( ( game->state == STATE_START ) || ( game->state == STATE_SENDER_LEVEL_PROMPT ) ) {
+        boardNavPush ( board, NAVSWITCH_PUSH );
+    } else if ( game->state == STATE_SENDER_DIFFICULTY ) {
+        boardNavPush ( board, game->difficulty < difficulty ? NAVSWITCH_NORTH : NAVSWITCH_PUSH );
+    } else if ( game->state == STATE_SENDER_DIRECTIONS ) {
+        boardNavPush ( board, boardRandom ( seed ) % 4 );
+    }
+}
+
+/**
+ * Bot B: plays RECEIVER, repeating each direction it was shown correctly
+ * with a chance of chance per mille, and otherwise a wrong one
+ */
+static void botReceiver ( board_t *board, unsigned chance, uint32_t *seed ) {
+    game_t *game = &board->game;
+
+    if ( ( game->state == STATE_RECEIVER_PROMPT ) || ( game->state == STATE_RECEIVER_GO )
+            || ( game->state == STATE_RECEIVER_LEVEL_WON ) ) {
+        boardNavPush ( board, NAVSWITCH_PUSH );
+    } else if ( game->state == STATE_RECEIVER_REPEAT ) {
+        uint8_t navswitch = navFor ( directionsGet ( &game->directions, game->attemptCount ) );
+
+        if ( boardRandom ( seed ) % 1000 >= chance ) {
+            navswitch = ( navswitch + 1 + boardRandom ( seed ) % 3 ) % 4;
+        }
+        boardNavPush ( board, navswitch );
+    }
+}
+
+/**
+ * Both bots of a board that plays SENDER and RECEIVER in turn. A board
+ * acknowledges the end of each game it plays RECEIVER in, and only the
+ * board that starts pushes at the "START GAME" scroll.
+ */
+static void botsPlay ( board_t *board, bool starts, char difficulty, uint32_t *seed ) {
+    game_t *game = &board->game;
+
+    if ( ( game->state == STATE_RECEIVER_FAILED ) || ( game->state == STATE_RECEIVER_GAME_WON ) ) {
+        boardNavPush ( board, NAVSWITCH_PUSH );
+    } else if ( ( game->state != STATE_START ) || starts ) {
+        botSender ( board, difficulty, seed );
+        botReceiver ( board, recall[ difficulty - 'A' ], seed );
+    }
+}
+
+/**
+ * Plays one whole match on its own pair of boards and records its results
+ */
+static void matchRun ( unsigned long match ) {
+    board_t boards[ 2 ];
+    uint8_t difficulty = match % DIFFICULTIES;
+    uint32_t seed = ( uint32_t ) ( match * 2654435761UL ) | 1;
+    uint32_t tick = 0;
+    uint64_t now = 0;
+    char level = 'A';
+    game_t *receiver = &boards[ 1 ].game;
+    int i;
+
+    for ( i = 0; i < 2; i++ ) {
+        boardInit ( &boards[ i ] );
+
+        if ( recordPrefix && !boardRecord ( &boards[ i ], recordPrefix, 'a' + i ) ) {
+            fprintf ( stderr, "match: cannot write %s.%c\n", recordPrefix, 'a' + i );
+        }
+    }
+
+    while ( ( receiver->state != STATE_RECEIVER_FAILED ) && ( receiver->state != STATE_RECEIVER_GAME_WON )
+            && ( tick < MATCH_TIMEOUT ) ) {
+        if ( tick % ( PACER_RATE * BOT_DELAY / 1000 ) == 0 ) {
+            botSender ( &boards[ 0 ], 'A' + difficulty, &seed );
+            botReceiver ( &boards[ 1 ], recall[ difficulty ], &seed );
+        }
+
+        for ( i = 0; i < 2; i++ ) {
+            boardTick ( &boards[ i ] );
+        }
+        channelUpdate ( &boards[ 0 ], &boards[ 1 ], now );
+        channelUpdate ( &boards[ 1 ], &boards[ 0 ], now );
+        now += TICK_NS;
+        tick++;
+
+        if ( ( receiver->gameLevel > level ) && ( receiver->gameLevel <= 'C' ) ) {
+            level = receiver->gameLevel;
+        }
+    }
+    results.difficulty[ match ] = difficulty + 1;
+    results.level[ match ] = level - 'A' + 1;
+    results.won[ match ] = tick == MATCH_TIMEOUT ? 2 : receiver->state == STATE_RECEIVER_GAME_WON;
+    results.ticks[ match ] = tick;
+    results.bytes[ match ] = boards[ 0 ].out.bytes + boards[ 1 ].out.bytes;
+
+    for ( i = 0; recordPrefix && ( i < 2 ); i++ ) {
+        if ( boards[ i ].log && !boardRecordEnd ( &boards[ i ] ) ) {
+            fprintf ( stderr, "match: cannot write %s.%c\n", recordPrefix, 'a' + i );
+        }
+    }
+}
+
+/**
+ * Plays a tournament for TOURNAMENT_MINUTES virtual minutes, every board
+ * having both bots, counting the matches completed. Only board 0's
+ * sender bot starts the tournament, and each receiver bot acknowledges
+ * the end of its match.
+ */
+static void *tournamentRun ( void *arg ) {
+    tournament_t *tournament = arg;
+    board_t boards[ TOURNAMENT_NODES_MAX ];
+    uint8_t shown[ TOURNAMENT_NODES_MAX ];
+    uint32_t seed = ( uint32_t ) ( tournament->nodes * 2654435761UL ) | 1;
+    uint32_t tick;
+    uint64_t now = 0;
+    game_t *game;
+    int i;
+
+    for ( i = 0; i < tournament->nodes; i++ ) {
+        boardInit ( &boards[ i ] );
+        playTournament ( &boards[ i ].game, i, tournament->nodes );
+        shown[ i ] = boards[ i ].game.state;
+    }
+
+    for ( tick = 0; tick < PACER_RATE * 60UL * TOURNAMENT_MINUTES; tick++ ) {
+        for ( i = 0; ( i < tournament->nodes ) && ( tick % ( PACER_RATE * BOT_DELAY / 1000 ) == 0 ); i++ ) {
+            botsPlay ( &boards[ i ], i == 0, 'A' + TOURNAMENT_DIFFICULTY, &seed );
+        }
+
+        for ( i = 0; i < tournament->nodes; i++ ) {
+            boardTick ( &boards[ i ] );
+            game = &boards[ i ].game;
+
+            if ( ( game->state != shown[ i ] )
+                    && ( ( game->state == STATE_RECEIVER_FAILED ) || ( game->state == STATE_RECEIVER_GAME_WON ) ) ) {
+                tournament->matches++;
+            }
+            shown[ i ] = game->state;
+        }
+        mediumUpdate ( boards, tournament->nodes, now );
+        now += TICK_NS;
+    }
+
+    for ( i = 0; i < tournament->nodes; i++ ) {
+        tournament->bytes += boards[ i ].out.bytes;
+        tournament->collisions += boards[ i ].out.collisions;
+    }
+    return 0;
+}
+
+/**
+ * Plays tournaments of 2 to TOURNAMENT_NODES_MAX boards, all at once,
+ * and reports each one's match rate and channel use
+ */
+static void tournamentsRun ( void ) {
+    tournament_t tournaments[ TOURNAMENT_NODES_MAX - 1 ] = { { 0 } };
+    pthread_t ids[ TOURNAMENT_NODES_MAX - 1 ];
+    int i;
+
+    for ( i = 0; i < TOURNAMENT_NODES_MAX - 1; i++ ) {
+        tournaments[ i ].nodes = i + 2;
+        pthread_create ( &ids[ i ], 0, tournamentRun, &tournaments[ i ] );
+    }
+    printf ( "boards  matches  matches/min  per board/h  IR bytes/s  collisions\n" );
+
+    for ( i = 0; i < TOURNAMENT_NODES_MAX - 1; i++ ) {
+        pthread_join ( ids[ i ], 0 );
+        printf ( "%6d  %7lu  %11.2f  %11.2f  %10.2f  %10lu\n", tournaments[ i ].nodes, tournaments[ i ].matches,
+                 ( double ) tournaments[ i ].matches / TOURNAMENT_MINUTES,
+                 60.0 * tournaments[ i ].matches / TOURNAMENT_MINUTES / tournaments[ i ].nodes,
+                 tournaments[ i ].bytes / ( 60.0 * TOURNAMENT_MINUTES ), tournaments[ i ].collisions );
+    }
+}
+
+/**
+ * Plays two boards for SOAK_MINUTES virtual minutes over a channel
+ * losing bytes, counting the levels played to a result and the longest
+ * time between two, and gathering the links' counts
+ */
+static void *soakRun ( void *arg ) {
+    soak_t *soak = arg;
+    board_t boards[ 2 ];
+    uint32_t seed = ( uint32_t ) ( ( soak->lossPerMille + 1 ) * 2654435761UL ) | 1;
+    uint32_t tick, lastLevel = 0;
+    uint64_t now = 0;
+    uint8_t shown[ 2 ];
+    const link_stats_t *stats;
+    int i;
+
+    for ( i = 0; i < 2; i++ ) {
+        boardInit ( &boards[ i ] );
+        boards[ i ].out.lossPerMille = soak->lossPerMille;
+        boards[ i ].out.seed = seed + i * 2;
+        shown[ i ] = boards[ i ].game.state;
+    }
+
+    for ( tick = 0; tick < PACER_RATE * 60UL * SOAK_MINUTES; tick++ ) {
+        for ( i = 0; ( i < 2 ) && ( tick % ( PACER_RATE * BOT_DELAY / 1000 ) == 0 ); i++ ) {
+            botsPlay ( &boards[ i ], i == 0, 'A' + TOURNAMENT_DIFFICULTY, &seed );
+        }
+
+        for ( i = 0; i < 2; i++ ) {
+            boardTick ( &boards[ i ] );
+
+            if ( ( boards[ i ].game.state != shown[ i ] ) && ( boards[ i ].game.state == STATE_RECEIVER_RESULT ) ) {
+                soak->levels++;
+                soak->longestGap = tick - lastLevel > soak->longestGap ? tick - lastLevel : soak->longestGap;
+                lastLevel = tick;
+            }
+            shown[ i ] = boards[ i ].game.state;
+        }
+        channelUpdate ( &boards[ 0 ], &boards[ 1 ], now );
+        channelUpdate ( &boards[ 1 ], &boards[ 0 ], now );
+        now += TICK_NS;
+    }
+    soak->longestGap = tick - lastLevel > soak->longestGap ? tick - lastLevel : soak->longestGap;
+
+    for ( i = 0; i < 2; i++ ) {
+        stats = linkStats ( &boards[ i ].game.link );
+        soak->lost += boards[ i ].out.lost;
+        soak->retransmissions += stats->retransmissions;
+        soak->duplicates += stats->duplicates;
+        soak->dropped += stats->dropped;
+        soak->longestDelivery = stats->longestDelivery > soak->longestDelivery ? stats->longestDelivery
+                                : soak->longestDelivery;
+    }
+    return 0;
+}
+
+/**
+ * Runs the soak test at every loss rate, all at once, and reports each
+ * one's level rate, the link's work and its worst recovery
+ */
+static void soaksRun ( void ) {
+    soak_t soaks[ SOAK_RUNS ] = { { 0 } };
+    pthread_t ids[ SOAK_RUNS ];
+    int i;
+
+    for ( i = 0; i < SOAK_RUNS; i++ ) {
+        soaks[ i ].lossPerMille = i * SOAK_LOSS_STEP * 10;
+        pthread_create ( &ids[ i ], 0, soakRun, &soaks[ i ] );
+    }
+    printf ( "loss  levels  levels/min  bytes lost  retransmits  duplicates  dropped  worst delivery ms  longest gap s\n" );
+
+    for ( i = 0; i < SOAK_RUNS; i++ ) {
+        pthread_join ( ids[ i ], 0 );
+        printf ( "%3u%%  %6lu  %10.2f  %10lu  %11lu  %10lu  %7lu  %17u  %13.1f\n", soaks[ i ].lossPerMille / 10,
+                 soaks[ i ].levels, ( double ) soaks[ i ].levels / SOAK_MINUTES, soaks[ i ].lost,
+                 soaks[ i ].retransmissions, soaks[ i ].duplicates, soaks[ i ].dropped, soaks[ i ].longestDelivery,
+                 ( double ) soaks[ i ].longestGap / PACER_RATE );
+    }
+}
+
+/**
+ * Takes the next chunk of matches from a worker's own range, or failing
+ * that steals the back half of the largest range left to another worker.
+ * Returns false once there are no matches left anywhere.
+ */
+static bool chunkTake ( int self, unsigned long *first, unsigned long *last ) {
+    worker_t *own = &workers[ self ];
+    worker_t *victim = 0;
+    unsigned long most = 0, half;
+    int i;
+
+    pthread_mutex_lock ( &own->lock );
+
+    if ( own->next < own->end ) {
+        *first = own->next;
+        *last = own->next + CHUNK < own->end ? own->next + CHUNK : own->end;
+        own->next = *last;
+        pthread_mutex_unlock ( &own->lock );
+        return true;
+    }
+    pthread_mutex_unlock ( &own->lock );
+
+    for ( i = 0; i < workerCount; i++ ) {
+        unsigned long left;
+
+        pthread_mutex_lock ( &workers[ i ].lock );
+        left = workers[ i ].end - workers[ i ].next;
+        pthread_mutex_unlock ( &workers[ i ].lock );
+
+        if ( left > most ) {
+            most = left;
+            victim = &workers[ i ];
+        }
+    }
+
+    if ( !victim ) {
+        return false;
+    }
+    pthread_mutex_lock ( &victim->lock );
+    half = ( victim->end - victim->next ) / 2;
+
+    if ( victim->next == victim->end ) {
+        pthread_mutex_unlock ( &victim->lock );
+        return chunkTake ( self, first, last );
+    }
+    *first = victim->end - ( half ? half : 1 );
+    *last = victim->end;
+    victim->end = *first;
+    pthread_mutex_unlock ( &victim->lock );
+
+    pthread_mutex_lock ( &own->lock );
+    own->stolen++;
+    own->next = *first;
+    own->end = *last;
+    pthread_mutex_unlock ( &own->lock );
+    return chunkTake ( self, first, last );
+}
+
+/**
+ * Worker thread: runs chunks of matches until none are left
+ */
+static void *workerRun ( void *arg ) {
+    int self = ( int ) ( intptr_t ) arg;
+    unsigned long first, last;
+
+    while ( chunkTake ( self, &first, &last ) ) {
+        while ( first < last ) {
+            matchRun ( first++ );
+        }
+    }
+    return 0;
+}
+
+/**
+ * Runs matches 0 to count - 1 on a number of threads, returning the wall time taken
+ */
+static double matchesRun ( unsigned long count, int threads ) {
+    pthread_t ids[ MAX_THREADS ];
+    struct timespec start, stop;
+    int i;
+
+    workerCount = threads;
+
+    for ( i = 0; i < threads; i++ ) {
+        pthread_mutex_init ( &workers[ i ].lock, 0 );
+        workers[ i ].next = count * i / threads;
+        workers[ i ].end = count * ( i + 1 ) / threads;
+        workers[ i ].stolen = 0;
+    }
+    clock_gettime ( CLOCK_MONOTONIC, &start );
+
+    for ( i = 0; i < threads; i++ ) {
+        pthread_create ( &ids[ i ], 0, workerRun, ( void * ) ( intptr_t ) i );
+    }
+
+    for ( i = 0; i < threads; i++ ) {
+        pthread_join ( ids[ i ], 0 );
+        pthread_mutex_destroy ( &workers[ i ].lock );
+    }
+    clock_gettime ( CLOCK_MONOTONIC, &stop );
+    return ( stop.tv_sec - start.tv_sec ) + ( stop.tv_nsec - start.tv_nsec ) / 1e9;
+}
+
+/**
+ * Allocates result columns for a number of matches
+ */
+static bool resultsAlloc ( unsigned long count ) {
+    results.difficulty = malloc ( count );
+    results.level = malloc ( count );
+    results.won = malloc ( count );
+    results.ticks = malloc ( count * sizeof ( uint32_t ) );
+    results.bytes = malloc ( count * sizeof ( uint16_t ) );
+    return results.difficulty && results.level && results.won && results.ticks && results.bytes;
+}
+
+/**
+ * Writes the result columns to a file
+ */
+static bool resultsWrite ( const char *path, unsigned long count ) {
+    FILE *file = fopen ( path, "wb" );
+    uint32_t header = count;
+    bool written;
+
+    if ( !file ) {
+        return false;
+    }
+    written = ( fwrite ( "MATCHES1", 8, 1, file ) == 1 ) && ( fwrite ( &header, 4, 1, file ) == 1 )
+              && ( fwrite ( results.difficulty, 1, count, file ) == count )
+              && ( fwrite ( results.level, 1, count, file ) == count )
+              && ( fwrite ( results.won, 1, count, file ) == count )
+              && ( fwrite ( results.ticks, 4, count, file ) == count )
+              && ( fwrite ( results.bytes, 2, count, file ) == count );
+    return ( fclose ( file ) == 0 ) && written;
+}
+
+/**
+ * Prints, for each difficulty, how often each level was reached and
+ * the game won, with the mean virtual length of a match
+ */
+static void resultsSummary ( unsigned long count ) {
+    unsigned long matches[ DIFFICULTIES ] = { 0 }, won[ DIFFICULTIES ] = { 0 }, timeouts = 0;
+    unsigned long reached[ DIFFICULTIES ][ 3 ] = { { 0 } };
+    double ticks[ DIFFICULTIES ] = { 0 };
+    unsigned long i;
+    int d;
+
+    for ( i = 0; i < count; i++ ) {
+        d = results.difficulty[ i ] - 1;
+        matches[ d ]++;
+        reached[ d ][ results.level[ i ] - 1 ]++;
+        won[ d ] += results.won[ i ] == 1;
+        timeouts += results.won[ i ] == 2;
+        ticks[ d ] += results.ticks[ i ];
+    }
+    printf ( "difficulty  matches   level 1  level 2  level 3  won     mean s\n" );
+
+    for ( d = 0; d < DIFFICULTIES; d++ ) {
+        if ( matches[ d ] ) {
+            printf ( "%10d  %-8lu  %6.1f%%  %6.1f%%  %6.1f%%  %5.1f%%  %6.1f\n", d + 1, matches[ d ],
+                     100.0 * reached[ d ][ 0 ] / matches[ d ], 100.0 * reached[ d ][ 1 ] / matches[ d ],
+                     100.0 * reached[ d ][ 2 ] / matches[ d ], 100.0 * won[ d ] / matches[ d ],
+                     ticks[ d ] / matches[ d ] / PACER_RATE );
+        }
+    }
+
+    if ( timeouts ) {
+        printf ( "%lu matches timed out\n", timeouts );
+    }
+}
+
+int main ( int argc, char *argv[] ) {
+    unsigned long count = 1000000, recordMatch = 0;
+    int threads = sysconf ( _SC_NPROCESSORS_ONLN );
+    const char *path = 0;
+    bool scaling = false, tournaments = false, soaks = false;
+    double seconds;
+    int opt;
+
+    while ( ( opt = getopt ( argc, argv, "n:j:o:stlr:m:" ) ) != -1 ) {
+        if ( opt == 'n' ) {
+            count = strtoul ( optarg, 0, 10 );
+        } else if ( opt == 'j' ) {
+            threads = atoi ( optarg );
+        } else if ( opt == 'o' ) {
+            path = optarg;
+        } else if ( opt == 's' ) {
+            scaling = true;
+        } else if ( opt == 't' ) {
+            tournaments = true;
+        } else if ( opt == 'l' ) {
+            soaks = true;
+        } else if ( opt == 'r' ) {
+            recordPrefix = optarg;
+        } else if ( opt == 'm' ) {
+            recordMatch = strtoul ( optarg, 0, 10 );
+        } else {
+            fprintf ( stderr, "usage: %s [-n matches] [-j threads] [-o file] [-s] [-t] [-l] [-r prefix [-m match]]\n",
+                      argv[ 0 ] );
+            return EXIT_FAILURE;
+        }
+    }
+
+    if ( tournaments ) {
+        tournamentsRun ();
+        return EXIT_SUCCESS;
+    } else if ( soaks ) {
+        soaksRun ();
+        return EXIT_SUCCESS;
+    } else if ( recordPrefix ) {
+        if ( !resultsAlloc ( recordMatch + 1 ) ) {
+            fprintf ( stderr, "match: bad match number\n" );
+            return EXIT_FAILURE;
+        }
+        matchRun ( recordMatch );
+        printf ( "match %lu  difficulty %u  level %u  %s  %.1f s\n", recordMatch, results.difficulty[ recordMatch ],
+                 results.level[ recordMatch ], results.won[ recordMatch ] == 1 ? "won" : "lost",
+                 ( double ) results.ticks[ recordMatch ] / PACER_RATE );
+        return EXIT_SUCCESS;
+    }
+
+    if ( ( threads < 1 ) || ( threads > MAX_THREADS ) || !count || !resultsAlloc ( count ) ) {
+        fprintf ( stderr, "match: bad thread or match count\n" );
+        return EXIT_FAILURE;
+    }
+
+    if ( scaling ) {
+        unsigned long matches = count < SCALING_MATCHES ? count : SCALING_MATCHES;
+        double single = 0;
+        int t;
+
+        printf ( "threads  matches/s  speedup\n" );
+
+        for ( t = 1; t <= threads; t = t < threads && t * 2 > threads ? threads : t * 2 ) {
+            seconds = matchesRun ( matches, t );
+            single = t == 1 ? seconds : single;
+            printf ( "%7d  %9.0f  %7.2f\n", t, matches / seconds, single / seconds );
+
+            if ( t == threads ) {
+                break;
+            }
+        }
+        return EXIT_SUCCESS;
+    }
+    seconds = matchesRun ( count, threads );
+    printf ( "%lu matches on %d threads in %.2f s, %.0f matches/s\n", count, threads, seconds, count / seconds );
+    resultsSummary ( count );
+
+    if ( path && !resultsWrite ( path, count ) ) {
+        fprintf ( stderr, "match: cannot write %s\n", path );
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,308 @@
+/**
+* @file     replay.c
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Host replay of the interactive memory game - one board's recorded game played again
+*
+* Reads a log recorded by sim.out -r or match.out -r, or the log carried
+* by the FRAME_RECORD frames of a capture of what a board built with
+* RECORD transmitted, or sim.out -s wrote, and plays that board's game
+* again from boardInit (), giving it each record just
+* before the pass it was acted on in: presses into the navswitch queue,
+* recepted bytes into the reception ring, bytes the UART took out of
+* the transmission ring, and the sample clock. Nothing else reaches the
+* game from outside, so it plays out as recorded, pass for pass, with no
+* other board and as fast as the host allows. The digest of its game
+* play at the end is checked against the log's, so a log serves as a
+* regression test: the exit status is 1 if they differ. With -n the log
+* is replayed a number of times over, for timing. A capture must hold
+* every frame of the log from the board's power on; frames of other
+* types, and bytes outside of frames or in bad ones, are skipped.
+*
+* Usage: replay [-n times] log|capture
+*/
+
+#include "board.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static const uint8_t valueBytes[ RECORD_KINDS ] = {
+    [ RECORD_NAV ] = 3,
+    [ RECORD_IR_RX ] = 1,
+    [ RECORD_IR_TX ] = 1,
+    [ RECORD_MILLIS ] = 2,
+    [ RECORD_END ] = 4
+};
+
+/**
+ * A log read into memory, and the next record of it: its kind, the
+ * pass it was acted on in and its value
+ */
+typedef struct {
+    uint8_t *bytes;
+    size_t length, next;
+    uint8_t node, nodes;
+    uint8_t kind;
+    uint32_t pass;
+    uint8_t value[ 4 ];
+} log_t;
+
+static board_t board;
+
+/**
+ * Gathers the log carried by a capture's FRAME_RECORD frames in place
+ * of the capture. A frame is looked for at every FRAME_START, so the
+ * bytes of other frames and of bad ones are skipped, as is a log frame
+ * cut short by the next FRAME_START, which was sent again whole.
+ * Returns false if a frame of the log is missing.
+ */
+static bool captureGather ( log_t *log ) {
+    const uint8_t *frame;
+    uint8_t payload[ FRAME_RECORD_BYTES + 1 ];
+    size_t at, next, length = 0;
+    uint8_t sequence = 0, size, crc, byte, i;
+
+    for ( at = 0; at + FRAME_OVERHEAD <= log->length; at++ ) {
+        frame = &log->bytes[ at ];
+        size = frame[ 3 ];
+
+        if ( ( frame[ 0 ] != FRAME_START ) || ( frame[ 1 ] != FRAME_RECORD ) || ( size > FRAME_RECORD_BYTES ) ) {
+            continue;
+        }
+
+        for ( next = at + FRAME_HEADER_SIZE, i = 0; ( i <= size ) && ( next < log->length ); i++ ) {
+            byte = log->bytes[ next++ ];
+
+            if ( ( byte == FRAME_ESCAPE ) && ( next < log->length ) && ( log->bytes[ next ] != FRAME_START ) ) {
+                byte = log->bytes[ next++ ] ^ FRAME_ESCAPE_FLIP;
+            } else if ( ( byte == FRAME_START ) || ( byte == FRAME_ESCAPE ) ) {
+                break;
+            }
+            payload[ i ] = byte;
+        }
+
+        if ( i <= size ) {
+            continue;
+        }
+
+        for ( crc = 0, i = 1; i < FRAME_HEADER_SIZE; i++ ) {
+            crc = crc8 ( crc, frame[ i ] );
+        }
+
+        for ( i = 0; i < size; i++ ) {
+            crc = crc8 ( crc, payload[ i ] );
+        }
+
+        if ( crc != payload[ size ] ) {
+            continue;
+        }
+
+        if ( frame[ 2 ] != sequence ) {
+            fprintf ( stderr, "replay: capture misses log frame %u\n", sequence );
+            return false;
+        }
+        memcpy ( &log->bytes[ length ], payload, size );
+        length += size;
+        sequence = ( sequence + 1 ) % RECORD_SEQUENCES;
+        at = next - 1;
+    }
+    log->length = length;
+    return true;
+}
+
+/**
+ * Reads a whole log, or gathers one from a capture, returning false if
+ * it cannot be read or holds no log
+ */
+static bool logLoad ( log_t *log, const char *path ) {
+    FILE *file = fopen ( path, "rb" );
+    long length;
+
+    if ( !file ) {
+        return false;
+    }
+    fseek ( file, 0, SEEK_END );
+    length = ftell ( file );
+    rewind ( file );
+    log->bytes = malloc ( length > 0 ? length : 1 );
+    log->length = fread ( log->bytes, 1, length > 0 ? length : 0, file );
+    fclose ( file );
+
+    if ( ( ( log->length < RECORD_MAGIC_BYTES ) || memcmp ( log->bytes, RECORD_MAGIC, RECORD_MAGIC_BYTES ) )
+         && !captureGather ( log ) ) {
+        return false;
+    }
+
+    if ( ( log->length < RECORD_MAGIC_BYTES + 2 ) || memcmp ( log->bytes, RECORD_MAGIC, RECORD_MAGIC_BYTES ) ) {
+        return false;
+    }
+    log->node = log->bytes[ RECORD_MAGIC_BYTES ];
+    log->nodes = log->bytes[ RECORD_MAGIC_BYTES + 1 ];
+    return true;
+}
+
+/**
+ * Starts reading the records of a log from the first
+ */
+static void logRewind ( log_t *log ) {
+    log->next = RECORD_MAGIC_BYTES + 2;
+    log->pass = 0;
+}
+
+/**
+ * Reads the next record of a log, returning false if there are no more
+ * or the log is cut short
+ */
+static bool logNext ( log_t *log ) {
+    uint32_t delta;
+    uint8_t byte, shift;
+
+    if ( log->next >= log->length ) {
+        return false;
+    }
+    byte = log->bytes[ log->next++ ];
+    log->kind = byte >> RECORD_DELTA_BITS;
+    delta = byte & RECORD_DELTA_LONG;
+
+    if ( log->kind >= RECORD_KINDS ) {
+        return false;
+    }
+
+    if ( delta == RECORD_DELTA_LONG ) {
+        delta = 0;
+
+        for ( shift = 0; ( log->next < log->length ) && ( shift < 32 ); shift += 7 ) {
+            byte = log->bytes[ log->next++ ];
+            delta |= ( uint32_t ) ( byte & 0x7F ) << shift;
+
+            if ( !( byte & 0x80 ) ) {
+                break;
+            }
+        }
+    }
+
+    if ( log->next + valueBytes[ log->kind ] > log->length ) {
+        return false;
+    }
+    memcpy ( log->value, &log->bytes[ log->next ], valueBytes[ log->kind ] );
+    log->next += valueBytes[ log->kind ];
+    log->pass += delta;
+    return true;
+}
+
+/**
+ * Gives the board the record just read, as it arrived before its pass
+ */
+static void recordApply ( const log_t *log ) {
+    game_t *game = &board.game;
+    input_event_t event;
+    uint8_t byte, count;
+
+    if ( log->kind == RECORD_NAV ) {
+        event.navswitch = log->value[ 0 ];
+        event.time = log->value[ 1 ] | log->value[ 2 ] << 8;
+        inputReplay ( &game->input, &event );
+    } else if ( log->kind == RECORD_IR_RX ) {
+        irReceiveByte ( &game->ir, log->value[ 0 ] );
+    } else if ( log->kind == RECORD_IR_TX ) {
+        for ( count = 0; count < log->value[ 0 ]; count++ ) {
+            irTransmitByte ( &game->ir, &byte );
+        }
+    } else if ( log->kind == RECORD_MILLIS ) {
+        game->input.millis = log->value[ 0 ] | log->value[ 1 ] << 8;
+    }
+}
+
+/**
+ * Replays a log from the start, setting the digest the game play ends
+ * with and the one recorded. Returns false if the log goes out of step
+ * with the game or has no end.
+ */
+static bool replayRun ( log_t *log, unsigned long *ticks, uint32_t *digest, uint32_t *recorded ) {
+    const pace_stats_t *stats = paceStats ( &board.game.pace );
+    bool more;
+
+    boardInit ( &board );
+
+    if ( log->nodes ) {
+        playTournament ( &board.game, log->node, log->nodes );
+    }
+    logRewind ( log );
+    more = logNext ( log );
+
+    for ( *ticks = 0; more; ( *ticks )++ ) {
+        if ( ( log->kind == RECORD_END ) && ( log->pass == stats->passes ) ) {
+            *digest = boardDigest ( &board );
+            *recorded = log->value[ 0 ] | log->value[ 1 ] << 8 | log->value[ 2 ] << 16 | ( uint32_t ) log->value[ 3 ] << 24;
+            return true;
+        }
+
+        if ( boardWait ( &board ) ) {
+            for ( ; more && ( log->pass == stats->passes ) && ( log->kind != RECORD_END ); more = logNext ( log ) ) {
+                recordApply ( log );
+            }
+
+            if ( more && ( log->pass < stats->passes ) ) {
+                return false;
+            }
+            gameTick ( &board.game );
+        }
+        boardScan ( &board );
+    }
+    return false;
+}
+
+int main ( int argc, char *argv[] ) {
+    const char *path = 0;
+    unsigned long times = 1, time, ticks = 0;
+    uint32_t digest = 0, recorded = 0, first = 0;
+    log_t log;
+    clock_t start;
+    double seconds;
+    int i;
+
+    for ( i = 1; i < argc; i++ ) {
+        if ( !strcmp ( argv[ i ], "-n" ) && ( i + 1 < argc ) ) {
+            times = strtoul ( argv[ ++i ], 0, 10 );
+        } else {
+            path = argv[ i ];
+        }
+    }
+
+    if ( !path || !times ) {
+        fprintf ( stderr, "usage: replay [-n times] log|capture\n" );
+        return EXIT_FAILURE;
+    }
+
+    if ( !logLoad ( &log, path ) ) {
+        fprintf ( stderr, "replay: cannot read log %s\n", path );
+        return EXIT_FAILURE;
+    }
+    start = clock ();
+
+    for ( time = 0; time < times; time++ ) {
+        if ( !replayRun ( &log, &ticks, &digest, &recorded ) ) {
+            fprintf ( stderr, "replay: %s %s at pass %lu\n", path,
+                      log.next >= log.length ? "ends without its digest" : "goes out of step",
+                      ( unsigned long ) paceStats ( &board.game.pace )->passes );
+            return EXIT_FAILURE;
+        }
+
+        if ( time && ( digest != first ) ) {
+            fprintf ( stderr, "replay: replay %lu of %s ends differently\n", time + 1, path );
+            return EXIT_FAILURE;
+        }
+        first = digest;
+    }
+    seconds = ( double ) ( clock () - start ) / CLOCKS_PER_SEC;
+
+    printf ( "%lu passes, %lu ticks, %.1f s virtual, replayed %lu times in %.3f s, %.0fx real time\n",
+             ( unsigned long ) paceStats ( &board.game.pace )->passes, ticks, ( double ) ticks / PACER_RATE, times,
+             seconds, seconds > 0 ? ( double ) ticks * times / PACER_RATE / seconds : 0 );
+    printf ( "state %u  level %c  score %u  digest %08lx  recorded %08lx  %s\n", ( unsigned ) board.game.state,
+             board.game.gameLevel, ( unsigned ) board.game.score, ( unsigned long ) digest, ( unsigned long ) recorded,
+             digest == recorded ? "same" : "DIFFERENT" );
+    return digest == recorded ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,374 @@
+/**
+* @file     sim.c
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Host simulation of the interactive memory game - two boards linked over a virtual infra-red channel
+*
+* Both boards are ticked at the pacer rate on a virtual clock, which runs
+* as fast as the host allows. Each infra-red byte takes the time it would
+* at the UART's baud rate to cross to the other board. Navswitch pushes
+* come from a script of lines "<time ms> <board A|B> <N|E|S|W|P>", read
+* from a file or from the built in script of one whole game, and every
+* change to a board's display or LED is logged against the virtual clock.
+* At the end, each board's reaction times as RECEIVER are listed, with
+* the last level's times it was sent as SENDER, and with -t each board's
+* event trace is dumped, as its infra-red bytes, to a file for
+* tools/tracedec. With -r each board's game is recorded, for sim/replay
+* to play again, and with -s board A's log is instead streamed over
+* infra-red, as a board built with RECORD streams it, and everything A
+* transmits captured to a file, which sim/replay plays again as well.
+* Each board's game play then ends in a digest, which for the built in
+* script, or for a script given the digests it should end in with -d,
+* is checked: on a mismatch sim exits non-zero. With -s, B also hears
+* A's log frames and passes them over, so its digest is checked as well:
+* streaming must not change how B plays.
+*/
+
+#include "board.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define SETTLE_MS 3000
+#define MAX_EVENTS 1024
+#define BOARDS 2
+#define SCRIPT_DIGEST_A 0x61b227d9UL // what the built in script's game play ends in on each board
+#define SCRIPT_DIGEST_B 0x75d1ed13UL
+
+/**
+ * A scripted navswitch push
+ */
+typedef struct {
+    unsigned long time;
+    uint8_t board;
+    uint8_t navswitch;
+} event_t;
+
+static board_t boards[ BOARDS ];
+static char shown[ BOARDS ][ 32 ];
+static bool ledShown[ BOARDS ];
+
+/**
+ * One whole game: A sends, B repeats three levels correctly and wins
+ */
+static const char defaultScript[] =
+    "500 A P\n"
+    "1500 A P\n"
+    "2000 A N\n"
+    "2500 A P\n"
+    "3000 A N\n3100 A E\n3200 A S\n3300 A W\n"
+    "4000 B P\n"
+    "8500 B P\n"
+    "9000 B N\n9100 B E\n9200 B S\n9300 B W\n"
+    "10500 B P\n"
+    "11000 A N\n11100 A N\n11200 A E\n11300 A S\n11400 A W\n11500 A W\n"
+    "12500 B P\n"
+    "21000 B P\n"
+    "21500 B N\n21600 B N\n21700 B E\n21800 B S\n21900 B W\n22000 B W\n"
+    "23000 B P\n"
+    "23500 A S\n23600 A S\n23700 A E\n23800 A E\n23900 A W\n24000 A W\n24100 A N\n24200 A N\n"
+    "25000 B P\n"
+    "37000 B P\n"
+    "37500 B S\n37600 B S\n37700 B E\n37800 B E\n37900 B W\n38000 B W\n38100 B N\n38200 B N\n"
+    "39500 B P\n";
+
+static event_t events[ MAX_EVENTS ];
+static int eventCount = 0;
+static bool quiet = false;
+
+/**
+ * Parses a script of navswitch pushes, returning false on a bad line
+ */
+static bool scriptParse ( const char *script ) {
+    static const char navswitches[] = "NESWP";
+    unsigned long time;
+    char board, navswitch;
+    int length;
+
+    while ( sscanf ( script, " %lu %c %c%n", &time, &board, &navswitch, &length ) == 3 ) {
+        const char *found = strchr ( navswitches, navswitch );
+
+        if ( ( eventCount == MAX_EVENTS ) || ( board < 'A' ) || ( board >= 'A' + BOARDS ) || !found ) {
+            return false;
+        }
+        events[ eventCount ].time = time;
+        events[ eventCount ].board = board - 'A';
+        events[ eventCount ].navswitch = found - navswitches;
+        eventCount++;
+        script += length;
+    }
+    return true;
+}
+
+/**
+ * Reads a script file into memory and parses it
+ */
+static bool scriptLoad ( const char *path ) {
+    static char script[ MAX_EVENTS * 16 ];
+    FILE *file = fopen ( path, "r" );
+    size_t length;
+
+    if ( !file ) {
+        return false;
+    }
+    length = fread ( script, 1, sizeof ( script ) - 1, file );
+    script[ length ] = 0;
+    fclose ( file );
+    return scriptParse ( script );
+}
+
+/**
+ * Logs any change in what a board displays or in its LED
+ */
+static void boardLog ( int i, uint64_t now ) {
+    const char *display = boardDisplay ( &boards[ i ] );
+    bool led = boardLed ( &boards[ i ] );
+
+    if ( strcmp ( display, shown[ i ] ) || ( led != ledShown[ i ] ) ) {
+        strncpy ( shown[ i ], display, sizeof ( shown[ i ] ) - 1 );
+        ledShown[ i ] = led;
+
+        if ( !quiet ) {
+            printf ( "%9.3f  %c  led %-3s  %s\n", now / 1e9, 'A' + i, led ? "on" : "off", display );
+        }
+    }
+}
+
+/**
+ * Lists a board's reaction times for each level and difficulty it has
+ * played as RECEIVER, and the last ones it was sent as SENDER
+ */
+static void reactionsPrint ( int i ) {
+    const game_t *game = &boards[ i ].game;
+    const react_report_t *peer = &game->peerReactions;
+    const react_t *cell;
+    uint8_t level, difficulty;
+
+    for ( level = 0; level < REACT_LEVELS; level++ ) {
+        for ( difficulty = 0; difficulty < REACT_DIFFICULTIES; difficulty++ ) {
+            cell = reactCell ( &game->reactions, level, difficulty );
+
+            if ( cell->count ) {
+                printf ( "%c  level %d difficulty %d  %3u reactions  min %5u  mean %8.2f  max %5u ms\n", 'A' + i,
+                         level + 1, difficulty + 1, cell->count, cell->min, cell->mean / 16.0, cell->max );
+            }
+        }
+    }
+
+    if ( peer->times.count ) {
+        printf ( "%c  sent level %d difficulty %d  %3u reactions  min %5u  mean %8.2f  max %5u ms\n", 'A' + i,
+                 peer->level + 1, peer->difficulty + 1, peer->times.count, peer->times.min, peer->times.mean / 16.0,
+                 peer->times.max );
+    }
+}
+
+/**
+ * Prints a board's link counts: its round trip histogram, then the rest
+ */
+static void linkPrint ( int i ) {
+    const link_stats_t *stats = linkStats ( &boards[ i ].game.link );
+    uint8_t bucket;
+
+    printf ( "%c  round trips", 'A' + i );
+
+    for ( bucket = 0; bucket < LINK_RTT_BUCKETS - 1; bucket++ ) {
+        printf ( "  <%u ms %u", LINK_RTT_FIRST << bucket, stats->rtt[ bucket ] );
+    }
+    printf ( "  longer %u\n", stats->rtt[ LINK_RTT_BUCKETS - 1 ] );
+    printf ( "%c  retransmits %u  duplicates %u  dropped %u  mismatches %u  unexpected %u  discarded bytes %u"
+             "  longest delivery %u ms  idle %.1f s  receive overruns %u\n", 'A' + i, stats->retransmissions,
+             stats->duplicates, stats->dropped, stats->mismatches, stats->unexpected, stats->discarded,
+             stats->longestDelivery, stats->idle / 1000.0, irOverruns ( &boards[ i ].game.ir ) );
+}
+
+/**
+ * Prints the frames a board's display redrew, scrolled and skipped
+ */
+static void displayPrint ( int i ) {
+    disp_stats_t stats = displayStats ( &boards[ i ].game.disp );
+
+    printf ( "%c  display frames redrawn %u  scrolled %u  skipped %u\n", 'A' + i, stats.redraws, stats.scrolls,
+             stats.skips );
+}
+
+/**
+ * Prints the navswitch bounces a board's debouncing absorbed and the
+ * presses its full queue dropped
+ */
+static void inputPrint ( int i ) {
+    input_t *input = &boards[ i ].game.input;
+
+    printf ( "%c  navswitch bounces coalesced %u  presses dropped %u\n", 'A' + i, inputCoalesced ( input ),
+             inputDropped ( input ) );
+}
+
+/**
+ * Prints the passes a board's game loop made, against the ticks it
+ * would have made at PACER_RATE throughout
+ */
+static void pacePrint ( int i, unsigned long ticks ) {
+    const pace_stats_t *stats = paceStats ( &boards[ i ].game.pace );
+
+    printf ( "%c  loop passes %lu of %lu ticks  %.1f%%\n", 'A' + i, ( unsigned long ) stats->passes, ticks,
+             100.0 * stats->passes / ticks );
+}
+
+/**
+ * Prints how a board's game ended and checks its digest against the one
+ * expected, if any. Returns false on a mismatch.
+ */
+static bool outcomeCheck ( int i, bool check, uint32_t expected ) {
+    const game_t *game = &boards[ i ].game;
+    uint32_t digest = boardDigest ( &boards[ i ] );
+
+    printf ( "%c  state %u  level %c  score %u  digest %08lx", 'A' + i, ( unsigned ) game->state, game->gameLevel,
+             ( unsigned ) game->score, ( unsigned long ) digest );
+
+    if ( check ) {
+        printf ( "  expected %08lx  %s", ( unsigned long ) expected, digest == expected ? "same" : "DIFFERENT" );
+    }
+    printf ( "\n" );
+    return !check || ( digest == expected );
+}
+
+/**
+ * Dumps each board's event trace to a file, as the infra-red bytes a
+ * board would send, board A's dump first
+ */
+static bool tracesWrite ( const char *path ) {
+    FILE *file = fopen ( path, "wb" );
+    ir_t ir;
+    uint8_t byte;
+    int i;
+
+    if ( !file ) {
+        return false;
+    }
+    irInit ( &ir );
+
+    for ( i = 0; i < BOARDS; i++ ) {
+        traceSelect ( &boards[ i ].game.trace );
+        traceDump ();
+
+        do {
+            traceDumpUpdate ( &ir );
+
+            while ( irTransmitByte ( &ir, &byte ) ) {
+                fputc ( byte, file );
+            }
+        } while ( traceDumping () );
+    }
+    return fclose ( file ) == 0;
+}
+
+int main ( int argc, char *argv[] ) {
+    const char *path = 0, *tracePath = 0, *recordPrefix = 0, *streamPath = 0;
+    uint32_t expected[ BOARDS ] = { SCRIPT_DIGEST_A, SCRIPT_DIGEST_B };
+    uint64_t now = 0, end;
+    unsigned long ticks = 0;
+    int next = 0, i;
+    bool check = false, same = true;
+    clock_t start;
+
+    for ( i = 1; i < argc; i++ ) {
+        if ( !strcmp ( argv[ i ], "-q" ) ) {
+            quiet = true;
+        } else if ( !strcmp ( argv[ i ], "-t" ) && ( i + 1 < argc ) ) {
+            tracePath = argv[ ++i ];
+        } else if ( !strcmp ( argv[ i ], "-r" ) && ( i + 1 < argc ) ) {
+            recordPrefix = argv[ ++i ];
+        } else if ( !strcmp ( argv[ i ], "-s" ) && ( i + 1 < argc ) ) {
+            streamPath = argv[ ++i ];
+        } else if ( !strcmp ( argv[ i ], "-d" ) && ( i + BOARDS < argc ) ) {
+            expected[ 0 ] = strtoul ( argv[ ++i ], 0, 16 );
+            expected[ 1 ] = strtoul ( argv[ ++i ], 0, 16 );
+            check = true;
+        } else {
+            path = argv[ i ];
+        }
+    }
+
+    if ( path ? !scriptLoad ( path ) : !scriptParse ( defaultScript ) ) {
+        fprintf ( stderr, "sim: cannot read script %s\n", path ? path : "(built in)" );
+        return EXIT_FAILURE;
+    }
+    check = check || !path;
+    end = ( ( eventCount ? events[ eventCount - 1 ].time : 0 ) + SETTLE_MS ) * 1000000ULL;
+
+    for ( i = 0; i < BOARDS; i++ ) {
+        boardInit ( &boards[ i ] );
+
+        if ( streamPath && ( i == 0 ) ) {
+            if ( !boardStream ( &boards[ i ], streamPath ) ) {
+                fprintf ( stderr, "sim: cannot write %s\n", streamPath );
+                return EXIT_FAILURE;
+            }
+        } else if ( recordPrefix && !boardRecord ( &boards[ i ], recordPrefix, 'a' + i ) ) {
+            fprintf ( stderr, "sim: cannot write %s.%c\n", recordPrefix, 'a' + i );
+            return EXIT_FAILURE;
+        }
+    }
+    start = clock ();
+
+    while ( now < end ) {
+        while ( ( next < eventCount ) && ( events[ next ].time * 1000000ULL <= now ) ) {
+            boardNavPush ( &boards[ events[ next ].board ], events[ next ].navswitch );
+            next++;
+        }
+
+        for ( i = 0; i < BOARDS; i++ ) {
+            boardTick ( &boards[ i ] );
+            boardLog ( i, now );
+        }
+        channelUpdate ( &boards[ 0 ], &boards[ 1 ], now );
+        channelUpdate ( &boards[ 1 ], &boards[ 0 ], now );
+        now += TICK_NS;
+        ticks++;
+    }
+
+    printf ( "%lu ticks, %.1f s virtual in %.3f s, IR bytes A->B %lu B->A %lu\n", ticks, now / 1e9,
+             ( double ) ( clock () - start ) / CLOCKS_PER_SEC, boards[ 0 ].out.bytes, boards[ 1 ].out.bytes );
+
+    for ( i = 0; i < BOARDS; i++ ) {
+        reactionsPrint ( i );
+    }
+
+    for ( i = 0; i < BOARDS; i++ ) {
+        linkPrint ( i );
+    }
+
+    for ( i = 0; i < BOARDS; i++ ) {
+        displayPrint ( i );
+    }
+
+    for ( i = 0; i < BOARDS; i++ ) {
+        inputPrint ( i );
+    }
+
+    for ( i = 0; i < BOARDS; i++ ) {
+        pacePrint ( i, ticks );
+    }
+
+    for ( i = 0; i < BOARDS; i++ ) {
+        same = outcomeCheck ( i, check, expected[ i ] ) && same;
+    }
+
+    if ( streamPath && !boardStreamEnd ( &boards[ 0 ] ) ) {
+        fprintf ( stderr, "sim: cannot write %s\n", streamPath );
+        return EXIT_FAILURE;
+    }
+
+    for ( i = streamPath ? 1 : 0; recordPrefix && ( i < BOARDS ); i++ ) {
+        if ( !boardRecordEnd ( &boards[ i ] ) ) {
+            fprintf ( stderr, "sim: cannot write %s.%c\n", recordPrefix, 'a' + i );
+            return EXIT_FAILURE;
+        }
+    }
+
+    if ( tracePath && !tracesWrite ( tracePath ) ) {
+        fprintf ( stderr, "sim: cannot write %s\n", tracePath );
+        return EXIT_FAILURE;
+    }
+    return same ? EXIT_SUCCESS : EXIT_FAILURE;
+}
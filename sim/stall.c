@@ -0,0 +1,161 @@
+/**
+* @file     stall.c
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Host check of the interactive memory game - game loop stalls on infra-red transmission
+*
+* Boards play a whole game as a pair, then a tournament of three, and
+* the bytes each pass of a game loop queues for transmission are taken
+* two ways. Before, ir_uart_putc () waited for room in the USART, which
+* holds a byte being shifted out and one more, so a pass stalled for a
+* byte time for each byte beyond what the USART had room for. That is
+* modelled from the times of the passes and BYTE_NS. Now bytes go to a
+* queue drained by the data register empty interrupt, which the pass
+* never waits on unless the queue is full, so the check fails if a pass
+* ever finds the queue full or drops a byte from it. Last, a board's game
+* loop stalls outright while its navswitch is pushed again and again, so
+* the press queue must fill, keep its first INPUT_QUEUE_SIZE presses in
+* order and count every one after as dropped.
+*
+* Usage: stall
+*/
+
+#include "board.h"
+#include "check.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PAIR_MINUTES 5 // a whole game takes well under this
+#define TOURNAMENT_MINUTES 10
+#define TOURNAMENT_BOARDS 3
+#define USART_BYTES 2 // the byte being shifted out and the data register
+#define STALL_PUSHES 5 // pushes beyond what the press queue holds
+#define PUSH_TICKS 20 // ticks from one push to the next, longer than a push is held and debounced
+
+/**
+ * The stall of one board's game loop on transmission, as ir_uart_putc ()
+ * would have had it, the deepest its transmission queue has been, and
+ * the bytes queued before the pass under way
+ */
+typedef struct {
+    uint64_t wireFree;
+    uint64_t stall, longest;
+    unsigned long passes, bytes, held;
+    uint8_t deepest, queued;
+} stall_t;
+
+/**
+ * Models a pass at a time writing bytes to the USART with a blocking
+ * putc: each byte waits until the USART has room for it, so the pass is
+ * held until all but the last USART_BYTES have gone onto the wire
+ */
+static void putcModel ( stall_t *stall, uint64_t now, uint8_t bytes ) {
+    uint64_t start = now, room;
+
+    while ( bytes-- ) {
+        room = stall->wireFree > ( USART_BYTES - 1 ) * BYTE_NS ? stall->wireFree - ( USART_BYTES - 1 ) * BYTE_NS : 0;
+        now = room > now ? room : now;
+        stall->wireFree = ( stall->wireFree > now ? stall->wireFree : now ) + BYTE_NS;
+        stall->bytes++;
+    }
+    stall->stall += now - start;
+    stall->longest = now - start > stall->longest ? now - start : stall->longest;
+    stall->held += now - start > TICK_NS;
+}
+
+/**
+ * Before a pass of a board's game loop: notes the bytes already queued
+ */
+static void passBefore ( board_run_t *run, board_t *board, int index ) {
+    stall_t *stall = ( stall_t * ) run->context + index;
+
+    stall->queued = ringCount ( &board->game.ir.tx );
+}
+
+/**
+ * After a pass of a board's game loop: checks it left room in the
+ * transmission queue, and models the stall the bytes it queued would
+ * have had
+ */
+static void passAfter ( board_run_t *run, board_t *board, int index ) {
+    stall_t *stall = ( stall_t * ) run->context + index;
+    ir_t *ir = &board->game.ir;
+    uint8_t queued = ringCount ( &ir->tx );
+
+    stall->passes++;
+    check ( !irWriteFull ( ir ), "pass left the transmission queue full", stall->passes );
+    putcModel ( stall, run->now, queued - stall->queued );
+    stall->deepest = queued > stall->deepest ? queued : stall->deepest;
+}
+
+/**
+ * Plays a number of boards, as a tournament if there are more than two,
+ * for a number of virtual minutes or, for a pair, until the RECEIVER
+ * wins the game, and reports each board's stalls
+ */
+static void stallsRun ( board_t *boards, stall_t *stalls, int count, unsigned minutes ) {
+    board_run_t run = { minutes, 0, true, 2463534242UL, 0, passBefore, passAfter, stalls };
+    int i;
+
+    memset ( stalls, 0, count * sizeof ( *stalls ) );
+    boardsRun ( boards, count, &run );
+
+    for ( i = 0; i < count; i++ ) {
+        printf ( "%-10s %c  %7lu  %6lu  %16.1f  %14.2f  %15lu  %12u\n", count > 2 ? "tournament" : "pair", 'A' + i,
+                 stalls[ i ].passes, stalls[ i ].bytes, stalls[ i ].stall / 1e6, stalls[ i ].longest / 1e6,
+                 stalls[ i ].held, stalls[ i ].deepest );
+        check ( irTxDropped ( &boards[ i ].game.ir ) == 0, "bytes dropped from a full transmission queue",
+                irTxDropped ( &boards[ i ].game.ir ) );
+    }
+}
+
+/**
+ * Pushes a board's navswitch while its game loop is stalled, with only
+ * the sampling interrupt running, then checks the presses the queue kept
+ * and the count of those it dropped
+ */
+static void inputStall ( board_t *board ) {
+    input_t *input = &board->game.input;
+    input_event_t event;
+    uint8_t push, tick, taken = 0;
+
+    boardInit ( board );
+
+    for ( push = 0; push < INPUT_QUEUE_SIZE + STALL_PUSHES; push++ ) {
+        boardNavPush ( board, push % NAVSWITCH_NUM );
+
+        for ( tick = 0; tick < PUSH_TICKS; tick++ ) {
+            boardWait ( board );
+        }
+    }
+
+    while ( inputGet ( input, &event ) ) {
+        check ( event.navswitch == taken % NAVSWITCH_NUM, "press taken out of order", taken );
+        taken++;
+    }
+    printf ( "%-12s  %u presses kept, %u dropped\n", "stalled loop", taken, inputDropped ( input ) );
+    check ( taken == INPUT_QUEUE_SIZE, "presses kept by a full queue", taken );
+    check ( inputDropped ( input ) == STALL_PUSHES, "presses counted as dropped", inputDropped ( input ) );
+}
+
+int main ( void ) {
+    static board_t boards[ TOURNAMENT_BOARDS ];
+    static stall_t stalls[ TOURNAMENT_BOARDS ];
+
+    printf ( "%-12s  %7s  %6s  %16s  %14s  %15s  %12s\n", "board", "passes", "bytes", "putc stall ms",
+             "longest ms", "held over tick", "queue deepest" );
+    stallsRun ( boards, stalls, 2, PAIR_MINUTES );
+    check ( boards[ 1 ].game.state == STATE_RECEIVER_GAME_WON, "game not won", boards[ 1 ].game.state );
+    check ( stalls[ 0 ].held > 0, "the putc model stalls no pass", stalls[ 0 ].held );
+    stallsRun ( boards, stalls, TOURNAMENT_BOARDS, TOURNAMENT_MINUTES );
+    inputStall ( &boards[ 0 ] );
+
+    if ( checkFailures () ) {
+        printf ( "stall: %u checks failed\n", checkFailures () );
+        return EXIT_FAILURE;
+    }
+    printf ( "stall: the queue never filled, so no pass waited on the wire, and a stalled loop's presses overflowed "
+             "as counted; all checks passed\n" );
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,166 @@
+/**
+* @file     stress.c
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Host check of the interactive memory game - ring buffer under a racing producer and consumer
+*
+* A producer thread stands in for the receive interrupt, putting a
+* count into a board's reception ring with irReceiveByte () a byte at a
+* time and noting each byte the full ring made it drop, while the main
+* thread stands in for the game loop, taking bytes as they come with
+* irGetc (). The threads race with no lock, so either can be stopped
+* anywhere in ringPut () or ringGet (). Afterwards the bytes taken must
+* be exactly the bytes put less those dropped, in order, irOverruns ()
+* must equal the drops, and the count seen by the consumer must never
+* have been more than RING_SIZE. The
+* producer puts bursts of random length, up to twice RING_SIZE, then
+* yields, as bytes arrive at the UART in frames, so the two interleave
+* even on one processor. This is done as it is, with the consumer
+* sleeping now and then, as a stalled game loop does, which must cause
+* overruns, and with bursts too short to fill the ring. Exits non-zero
+* on a failure.
+*
+* Usage: stress
+*/
+
+#include "board.h"
+#include "check.h"
+#include "ir.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BYTES 2000000UL
+#define STALL_BYTES 65536 // bytes taken between a stalling consumer's sleeps
+#define STALL_NS 1000000 // ns a stalling consumer sleeps for
+
+/**
+ * How a run's producer and consumer go about it
+ */
+typedef enum {
+    RUN_BURSTS,
+    RUN_CONSUMER_STALLS,
+    RUN_SHORT_BURSTS,
+    RUN_COUNT
+} run_t;
+
+static const char *const runNames[ RUN_COUNT ] = { "bursts", "consumer stalls", "short bursts" };
+static const uint8_t runBursts[ RUN_COUNT ] = { 2 * RING_SIZE, 2 * RING_SIZE, RING_SIZE / 2 };
+
+static ir_t ir;
+static run_t run;
+static bool done;
+static bool dropped[ BYTES ];
+static uint8_t taken[ BYTES ];
+/**
+ * The interrupt: puts each byte of the count in bursts, noting those
+ * dropped
+ */
+static void *producerRun ( void *unused ) {
+    uint32_t seed = 2463534242UL;
+    unsigned long i, burst = 0;
+    uint16_t overruns;
+
+    ( void ) unused;
+
+    for ( i = 0; i < BYTES; i++ ) {
+        overruns = ir.rx.overruns;
+        irReceiveByte ( &ir, ( uint8_t ) i );
+        dropped[ i ] = ir.rx.overruns != overruns;
+
+        if ( burst-- == 0 ) {
+            burst = boardRandom ( &seed ) % runBursts[ run ];
+            sched_yield ();
+        }
+    }
+    __atomic_store_n ( &done, true, __ATOMIC_RELEASE );
+    return 0;
+}
+
+/**
+ * The game loop: takes bytes until the producer is done and the ring
+ * is empty, checking the count it sees, and yielding whenever it is
+ * empty so a producer sharing its processor gets to run. Returns the
+ * bytes taken.
+ */
+static unsigned long consumerRun ( void ) {
+    static const struct timespec stall = { 0, STALL_NS };
+    unsigned long count = 0;
+    uint8_t byte, waiting;
+    bool finished = false;
+
+    while ( !finished ) {
+        finished = __atomic_load_n ( &done, __ATOMIC_ACQUIRE );
+        waiting = ringCount ( &ir.rx );
+        check ( waiting <= RING_SIZE, "ring count out of range", waiting );
+
+        while ( irReadReady ( &ir ) ) {
+            byte = irGetc ( &ir );
+
+            if ( count < BYTES ) {
+                taken[ count ] = byte;
+            }
+            count++;
+
+            if ( ( run == RUN_CONSUMER_STALLS ) && ( count % STALL_BYTES == 0 ) ) {
+                nanosleep ( &stall, 0 );
+            }
+        }
+        sched_yield ();
+    }
+    return count;
+}
+
+/**
+ * Races a producer and consumer through the ring, checks what was taken
+ * against what was put, and returns the overruns
+ */
+static unsigned long ringRace ( void ) {
+    pthread_t producer;
+    unsigned long count, drops = 0, i, next = 0;
+
+    irInit ( &ir );
+    done = false;
+    pthread_create ( &producer, 0, producerRun, 0 );
+    count = consumerRun ();
+    pthread_join ( producer, 0 );
+
+    for ( i = 0; i < BYTES; i++ ) {
+        if ( dropped[ i ] ) {
+            drops++;
+        } else if ( next < count ) {
+            if ( taken[ next++ ] != ( uint8_t ) i ) {
+                check ( false, "byte taken out of order or changed", i );
+                break;
+            }
+        }
+    }
+    check ( count + drops == BYTES, "bytes taken and dropped do not add up", count + drops );
+    check ( irOverruns ( &ir ) == ( uint16_t ) drops, "overrun count differs from the drops", irOverruns ( &ir ) );
+    printf ( "%-16s  %8lu bytes taken  %8lu dropped\n", runNames[ run ], count, drops );
+    return drops;
+}
+
+int main ( void ) {
+    char where[ 24 ];
+    unsigned long drops;
+
+    for ( run = 0; run < RUN_COUNT; run++ ) {
+        snprintf ( where, sizeof ( where ), "in %s", runNames[ run ] );
+        checkWhere ( where );
+        drops = ringRace ();
+
+        if ( run == RUN_CONSUMER_STALLS ) {
+            check ( drops > 0, "a stalling consumer caused no overruns", drops );
+        }
+    }
+
+    if ( checkFailures () ) {
+        printf ( "stress: %u checks failed\n", checkFailures () );
+        return EXIT_FAILURE;
+    }
+    printf ( "stress: all checks passed\n" );
+    return EXIT_SUCCESS;
+}
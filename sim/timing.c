@@ -0,0 +1,139 @@
+/**
+* @file     timing.c
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Host check of the interactive memory game - tick clock and deadline timing on a fake clock
+*
+* Drives tick.c directly as a fake clock, a pacer period per
+* tickUpdate (), and checks its timing is exact: the clock reads the
+* whole milliseconds elapsed after every tick at each pacer rate, with
+* no error building up; a deadline expires on the first tick at or past
+* it, never before and never a whole period after; deadlines stay right
+* across the clock wrapping; and changing the rate, as the game loop
+* does between play and idle, loses less than a 1/rate ms step of the
+* slower rate each time. Exits non-zero on a failure.
+*
+* Usage: timing
+*/
+
+#include "check.h"
+#include "tick.h"
+#include "game.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SECONDS 600
+#define WRAP_MS 0xFFFFFC00UL // near the top of the clock, so deadlines set here wrap
+
+static const uint16_t rates[] = { PACER_RATE, PACER_IDLE_RATE, 1000, 333, 7 };
+static const uint16_t delays[] = { 0, 1, 3, 200, 400, 500, 600, 1000, 1400, 65535 };
+
+/**
+ * Names the rate the checks that follow are made at
+ */
+static void rateWhere ( uint16_t rate ) {
+    char where[ 16 ];
+
+    snprintf ( where, sizeof ( where ), "at %u Hz", rate );
+    checkWhere ( where );
+}
+
+/**
+ * Checks the clock reads the whole milliseconds elapsed after every
+ * tick for a number of seconds at a rate
+ */
+static void clockCheck ( uint16_t rate ) {
+    tick_t tick;
+    unsigned long ticks;
+
+    rateWhere ( rate );
+    tickInit ( &tick, rate );
+
+    for ( ticks = 1; ticks <= ( unsigned long ) SECONDS * rate; ticks++ ) {
+        tickUpdate ( &tick );
+
+        if ( tickMillis ( &tick ) != ticks * 1000 / rate ) {
+            check ( false, "clock reads wrong after tick", ticks );
+            return;
+        }
+    }
+    check ( tickMillis ( &tick ) == SECONDS * 1000UL, "clock drifts over whole seconds", tickMillis ( &tick ) );
+}
+
+/**
+ * Checks a deadline set at a clock time expires on the first tick at or
+ * past it, returning the ticks it took
+ */
+static unsigned long deadlineCheck ( uint16_t rate, uint32_t from, uint16_t delay ) {
+    tick_t tick;
+    deadline_t deadline;
+    unsigned long ticks = 0;
+
+    rateWhere ( rate );
+    tickInit ( &tick, rate );
+    tick.millis = from;
+    deadlineSet ( &tick, &deadline, delay );
+
+    while ( !deadlineExpired ( &tick, &deadline ) ) {
+        tickUpdate ( &tick );
+        ticks++;
+    }
+    check ( ( uint32_t ) ( tick.millis - from ) >= delay, "deadline expires early", delay );
+    check ( ( ( uint32_t ) ( tick.millis - from ) - delay ) * rate < 1000, "deadline expires a period late",
+            delay );
+    check ( ticks == ( delay * ( unsigned long ) rate + 999 ) / 1000, "deadline takes the wrong ticks", delay );
+    return ticks;
+}
+
+/**
+ * Checks that moving between two rates a number of times loses less
+ * than a step of the slower rate each time, counting the part
+ * millisecond carried. Returns the time lost to scaling the part
+ * millisecond, in thousandths of a millisecond.
+ */
+static long rateCheck ( uint16_t play, uint16_t idle, unsigned switches ) {
+    tick_t tick;
+    double elapsed = 0;
+    unsigned i, ticks;
+    uint16_t rate = play;
+    long error;
+
+    rateWhere ( play );
+    tickInit ( &tick, rate );
+
+    for ( i = 0; i < switches; i++ ) {
+        for ( ticks = 0; ticks < 1 + i % 97; ticks++ ) {
+            tickUpdate ( &tick );
+            elapsed += 1000.0 / rate;
+        }
+        rate = rate == play ? idle : play;
+        tickRate ( &tick, rate );
+    }
+    error = ( long ) ( ( elapsed - tickMillis ( &tick ) - ( double ) tick.remainder / tick.rate ) * 1000 + 0.5 );
+    check ( ( error >= 0 ) && ( error < 1000L * switches / idle ), "clock strays across rate changes", error );
+    return error;
+}
+
+int main ( void ) {
+    unsigned long ticks;
+    uint8_t r, d;
+
+    for ( r = 0; r < sizeof ( rates ) / sizeof ( rates[ 0 ] ); r++ ) {
+        clockCheck ( rates[ r ] );
+
+        for ( d = 0; d < sizeof ( delays ) / sizeof ( delays[ 0 ] ); d++ ) {
+            ticks = deadlineCheck ( rates[ r ], WRAP_MS, delays[ d ] );
+            check ( ticks == deadlineCheck ( rates[ r ], 0, delays[ d ] ), "deadline wraps differently", delays[ d ] );
+        }
+        printf ( "%4u Hz  clock checked over %u s, deadlines of 0 to 65535 ms\n", rates[ r ], SECONDS );
+    }
+    printf ( "%d/%d Hz  2 rate changes lose %ld/1000 ms, 200 lose %ld/1000 ms\n", PACER_RATE, PACER_IDLE_RATE,
+             rateCheck ( PACER_RATE, PACER_IDLE_RATE, 2 ), rateCheck ( PACER_RATE, PACER_IDLE_RATE, 200 ) );
+
+    if ( checkFailures () ) {
+        printf ( "timing: %u checks failed\n", checkFailures () );
+        return EXIT_FAILURE;
+    }
+    printf ( "timing: all checks passed\n" );
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,69 @@
+/**
+* @file     tick.c
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    C program for an interactive memory game between microcontrollers - pacer driven timers
+*
+* The clock only advances when tickUpdate () is called, so the
+* length of a timer depends on the pacer rate rather than on how
+* long the display and game code take to run. Nothing here touches
+* hardware, letting a host build drive the clock as a fake clock.
+*/
+
+#include "tick.h"
+
+#define MILLIS_PER_SECOND 1000
+
+/**
+ * Initialiser for the tick clock at the rate the pacer is run at
+ */
+void tickInit ( tick_t *tick, uint16_t loopRate ) {
+    tick->rate = loopRate;
+    tick->remainder = 0;
+    tick->millis = 0;
+}
+
+/**
+ * Changes the rate the pacer is run at. The remainder, in parts of a
+ * millisecond a rate's worth, is scaled to the new rate.
+ */
+void tickRate ( tick_t *tick, uint16_t loopRate ) {
+    tick->remainder = ( uint32_t ) tick->remainder * loopRate / tick->rate;
+    tick->rate = loopRate;
+}
+
+/**
+ * Advances the tick clock by one pacer period. Whole milliseconds are
+ * carried forward with the remainder kept, so that no rounding error
+ * builds up, e.g. at 300 Hz every 300 ticks are exactly 1000 ms.
+ */
+void tickUpdate ( tick_t *tick ) {
+    tick->remainder += MILLIS_PER_SECOND;
+
+    while ( tick->remainder >= tick->rate ) {
+        tick->remainder -= tick->rate;
+        tick->millis++;
+    }
+}
+
+/**
+ * Returns the number of milliseconds elapsed since tickInit ()
+ */
+uint32_t tickMillis ( const tick_t *tick ) {
+    return tick->millis;
+}
+
+/**
+ * Sets a deadline a number of milliseconds from now
+ */
+void deadlineSet ( const tick_t *tick, deadline_t *deadline, uint16_t milliseconds ) {
+    *deadline = tick->millis + milliseconds;
+}
+
+/**
+ * Returns true once the tick clock has reached the deadline.
+ * The signed difference keeps this correct across clock wrap-around.
+ */
+bool deadlineExpired ( const tick_t *tick, const deadline_t *deadline ) {
+    return ( int32_t ) ( tick->millis - *deadline ) >= 0;
+}
@@ -0,0 +1,67 @@
+/**
+* @file     tick.h
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Header file for tick.c of the interactive memory game between microcontrollers - pacer driven timers
+*/
+
+#ifndef TICK_H
+#define TICK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/**
+ * Millisecond deadline, set relative to the current tick time
+ */
+typedef uint32_t deadline_t;
+
+
+/**
+ * Tick clock of one game, in milliseconds since it was initialised
+ */
+typedef struct {
+    uint16_t rate;
+    uint16_t remainder;
+    uint32_t millis;
+} tick_t;
+
+
+/**
+ * Initialiser for the tick clock at the rate the pacer is run at
+ */
+void tickInit ( tick_t *tick, uint16_t loopRate );
+
+
+/**
+ * Changes the rate the pacer is run at, keeping the part millisecond
+ * carried
+ */
+void tickRate ( tick_t *tick, uint16_t loopRate );
+
+
+/**
+ * Advances the tick clock by one pacer period. Called once after
+ * every paceWait (), or directly by a host build as a fake clock.
+ */
+void tickUpdate ( tick_t *tick );
+
+
+/**
+ * Returns the number of milliseconds elapsed since tickInit ()
+ */
+uint32_t tickMillis ( const tick_t *tick );
+
+
+/**
+ * Sets a deadline a number of milliseconds from now
+ */
+void deadlineSet ( const tick_t *tick, deadline_t *deadline, uint16_t milliseconds );
+
+
+/**
+ * Returns true once the tick clock has reached the deadline
+ */
+bool deadlineExpired ( const tick_t *tick, const deadline_t *deadline );
+#endif
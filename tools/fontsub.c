@@ -0,0 +1,289 @@
+/**
+* @file     fontsub.c
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Build tool for the interactive memory game between microcontrollers - font subsetting
+*
+* Writes a header holding just the listed glyphs of font3x5_1 or
+* font5x7_1, in flash, indexed by a string of the chars they draw. Each
+* glyph's bytes are copied unchanged, so are read as font.c reads them,
+* or with -r are pre-rendered as a byte per column, row 0 the low bit,
+* ready to be copied to the display a column at a time.
+*
+* Usage: fontsub -f 3x5|5x7 -g glyphs -n name -o header [-r] [-l chars] [-s file.c] [-c file.c ...]
+*
+* -s checks every char of the PROGMEM strings in a source file is
+* among the glyphs, and with -l that no string is longer than a number
+* of chars. -c checks every char literal, or char #define, shown by
+* displayConst in a source file is among the glyphs, as is the glyph of
+* each ROW of the level table, and may be given more than once to check
+* more files. Any check failing
+* stops the build, and no header is written.
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// The UCFK4 font.h needs only uint8_t and bool from system.h, whose AVR registers a host cannot include
+#define SYSTEM_H
+#include "font3x5_1.h"
+#include "font5x7_1.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define LINE_MAX 256
+#define CONSTS_MAX 4 // files -c may be given
+
+static const char *glyphs = "";
+static const char *name = "glyphs";
+static bool columns;
+static size_t longest = SIZE_MAX;
+static int errors;
+
+/**
+ * Reports a char a source file needs that is not among the glyphs
+ */
+static void glyphCheck ( const char *path, int line, char ch, const char *use ) {
+    if ( !strchr ( glyphs, ch ) ) {
+        fprintf ( stderr, "%s:%d: %s '%c', which has no glyph in %s\n", path, line, use, ch, name );
+        errors++;
+    }
+}
+
+/**
+ * Checks the chars of every string literal on PROGMEM lines of a source file
+ */
+static void stringsCheck ( const char *path ) {
+    FILE *file = fopen ( path, "r" );
+    char text[ LINE_MAX ];
+    int line = 0;
+
+    if ( !file ) {
+        perror ( path );
+        exit ( EXIT_FAILURE );
+    }
+
+    while ( fgets ( text, sizeof ( text ), file ) ) {
+        char *quote = strchr ( text, '"' ), *start;
+
+        line++;
+
+        if ( !strstr ( text, "PROGMEM" ) || !quote ) {
+            continue;
+        }
+
+        start = quote + 1;
+
+        while ( *++quote && ( *quote != '"' ) ) {
+            glyphCheck ( path, line, *quote, "string uses" );
+        }
+
+        if ( ( size_t ) ( quote - start ) > longest ) {
+            fprintf ( stderr, "%s:%d: string is longer than %d chars\n", path, line, ( int ) longest );
+            errors++;
+        }
+    }
+    fclose ( file );
+}
+
+/**
+ * Returns the char a #define in a source file gives a name, or 0
+ */
+static char defineFind ( const char *path, const char *macro ) {
+    FILE *file = fopen ( path, "r" );
+    char text[ LINE_MAX ], defined[ LINE_MAX ], ch = 0;
+
+    while ( file && fgets ( text, sizeof ( text ), file ) ) {
+        char value;
+
+        if ( ( sscanf ( text, "#define %255s '%c'", defined, &value ) == 2 ) && !strcmp ( defined, macro ) ) {
+            ch = value;
+        }
+    }
+
+    if ( file ) {
+        fclose ( file );
+    }
+    return ch;
+}
+
+/**
+ * Checks the char shown by every displayConst call of a source file,
+ * and the glyph of every ROW of its level table
+ */
+static void constsCheck ( const char *path ) {
+    FILE *file = fopen ( path, "r" );
+    char text[ LINE_MAX ];
+    int line = 0;
+
+    if ( !file ) {
+        perror ( path );
+        exit ( EXIT_FAILURE );
+    }
+
+    while ( fgets ( text, sizeof ( text ), file ) ) {
+        char *call = strstr ( text, "displayConst (" );
+        char *arg, *end, macro[ LINE_MAX ], glyph;
+        unsigned directions;
+        size_t length;
+
+        line++;
+
+        if ( sscanf ( text, " ROW ( %u , '%c' )", &directions, &glyph ) == 2 ) {
+            glyphCheck ( path, line, glyph, "a level shows" );
+            continue;
+        }
+
+        if ( !call || !( arg = strchr ( call, ',' ) ) || !( end = strchr ( arg, ')' ) ) ) {
+            continue;
+        }
+
+        while ( isspace ( ( unsigned char ) *++arg ) ) {
+        }
+
+        if ( *arg == '\'' ) {
+            glyphCheck ( path, line, arg[ 1 ], "displayConst shows" );
+            continue;
+        }
+
+        for ( length = 0; ( arg + length < end ) && ( isalnum ( ( unsigned char ) arg[ length ] ) || arg[ length ] == '_' ); length++ ) {
+            macro[ length ] = arg[ length ];
+        }
+        macro[ length ] = 0;
+
+        if ( defineFind ( path, macro ) ) {
+            glyphCheck ( path, line, defineFind ( path, macro ), "displayConst shows" );
+        } else if ( length ) {
+            fprintf ( stderr, "%s:%d: displayConst shows %s, which is not a char #define\n", path, line, macro );
+            errors++;
+        }
+    }
+    fclose ( file );
+}
+
+/**
+ * Returns a byte of a glyph as written to the header: packed as in the
+ * font, or a pre-rendered column
+ */
+static uint8_t glyphByte ( const font_t *font, char ch, uint8_t byte ) {
+    const uint8_t *data = font->data + ( ch - font->offset ) * font->bytes;
+    uint8_t column = 0, row, bit;
+
+    if ( !columns ) {
+        return data[ byte ];
+    }
+
+    for ( row = 0; row < font->height; row++ ) {
+        bit = row * font->width + byte;
+
+        if ( data[ bit / 8 ] & ( 1 << ( bit % 8 ) ) ) {
+            column |= 1 << row;
+        }
+    }
+    return column;
+}
+
+/**
+ * Writes the subset of a font as a header
+ */
+static void subsetWrite ( const font_t *font, const char *fontName, const char *path ) {
+    FILE *file;
+    size_t count = strlen ( glyphs ), glyph;
+    uint8_t bytes = columns ? font->width : font->bytes, byte;
+
+    for ( glyph = 0; glyph < count; glyph++ ) {
+        if ( ( glyphs[ glyph ] < font->offset ) || ( glyphs[ glyph ] >= font->offset + font->size ) ) {
+            fprintf ( stderr, "fontsub: %s has no glyph for '%c'\n", fontName, glyphs[ glyph ] );
+            exit ( EXIT_FAILURE );
+        }
+    }
+
+    if ( !( file = fopen ( path, "w" ) ) ) {
+        perror ( path );
+        exit ( EXIT_FAILURE );
+    }
+    fprintf ( file, "/**\n* @file     %s\n* @brief    %s subset of %s, written by tools/fontsub; do not edit\n*/\n\n",
+              path, name, fontName );
+    fprintf ( file, "#include \"flash.h\"\n#include \"glyph.h\"\n\n" );
+    fprintf ( file, "static const char %sChars[] PROGMEM = \"", name );
+
+    for ( glyph = 0; glyph < count; glyph++ ) {
+        fprintf ( file, glyphs[ glyph ] == '"' || glyphs[ glyph ] == '\\' ? "\\%c" : "%c", glyphs[ glyph ] );
+    }
+    fprintf ( file, "\";\n\nstatic const uint8_t %sData[] PROGMEM = {", name );
+
+    for ( glyph = 0; glyph < count; glyph++ ) {
+        fprintf ( file, "\n   " );
+
+        for ( byte = 0; byte < bytes; byte++ ) {
+            fprintf ( file, " 0x%02x,", glyphByte ( font, glyphs[ glyph ], byte ) );
+        }
+        fprintf ( file, " // '%c'", glyphs[ glyph ] );
+    }
+    fprintf ( file, "\n};\n\nstatic const glyph_font_t %s = { %d, %d, %d, %d, %s, %sChars, %sData };\n",
+              name, font->width, font->height, bytes, ( int ) count, columns ? "true" : "false", name, name );
+
+    if ( fclose ( file ) ) {
+        perror ( path );
+        exit ( EXIT_FAILURE );
+    }
+    printf ( "%s: %d of %d glyphs of %s, %d of %d bytes\n", name, ( int ) count, font->size, fontName,
+             ( int ) ( count * ( bytes + 1 ) ), font->size * font->bytes );
+}
+
+int main ( int argc, char *argv[] ) {
+    const char *size = 0, *path = 0, *strings = 0, *consts[ CONSTS_MAX ];
+    int opt, count = 0, i;
+
+    while ( ( opt = getopt ( argc, argv, "f:g:n:o:rl:s:c:" ) ) != -1 ) {
+        if ( opt == 'f' ) {
+            size = optarg;
+        } else if ( opt == 'g' ) {
+            glyphs = optarg;
+        } else if ( opt == 'n' ) {
+            name = optarg;
+        } else if ( opt == 'o' ) {
+            path = optarg;
+        } else if ( opt == 'r' ) {
+            columns = true;
+        } else if ( opt == 'l' ) {
+            longest = strtoul ( optarg, 0, 10 );
+        } else if ( opt == 's' ) {
+            strings = optarg;
+        } else if ( ( opt == 'c' ) && ( count < CONSTS_MAX ) ) {
+            consts[ count++ ] = optarg;
+        } else {
+            return EXIT_FAILURE;
+        }
+    }
+
+    if ( !size || !path ) {
+        fprintf ( stderr, "usage: %s -f 3x5|5x7 -g glyphs -n name -o header [-r] [-l chars] [-s file.c] [-c file.c ...]\n", argv[ 0 ] );
+        return EXIT_FAILURE;
+    }
+
+    if ( strings ) {
+        stringsCheck ( strings );
+    }
+
+    for ( i = 0; i < count; i++ ) {
+        constsCheck ( consts[ i ] );
+    }
+
+    if ( errors ) {
+        return EXIT_FAILURE;
+    }
+
+    if ( !strcmp ( size, "3x5" ) ) {
+        subsetWrite ( &font3x5_1, "font3x5_1", path );
+    } else if ( !strcmp ( size, "5x7" ) ) {
+        subsetWrite ( &font5x7_1, "font5x7_1", path );
+    } else {
+        fprintf ( stderr, "fontsub: no font %s\n", size );
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,160 @@
+/**
+* @file     tracedec.c
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Host tool for the interactive memory game between microcontrollers - event trace decoder
+*
+* Reads the infra-red bytes of one or more trace dumps, as captured from
+* a board or written by sim.out -t, and prints each dump as a timeline.
+* Frames of other types, bytes outside of frames and frames failing
+* their CRC are skipped. A frame with sequence number 0 starts a new
+* dump. Event times are the tick clock's millisecond modulo 65536, so
+* each wrap within a dump is added back.
+*
+* Usage: tracedec [file ...]
+*/
+
+#include "play.h"
+#include "trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+static const char *const kinds[ TRACE_KINDS ] = {
+    [ TRACE_STATE ] = "state",
+    [ TRACE_IR_TX ] = "ir tx",
+    [ TRACE_IR_RX ] = "ir rx",
+    [ TRACE_NAV ] = "nav",
+    [ TRACE_LEVEL ] = "level"
+};
+
+static const char *const states[ STATE_COUNT ] = {
+    [ STATE_START ] = "START",
+    [ STATE_SENDER_LEVEL_PROMPT ] = "SENDER_LEVEL_PROMPT",
+    [ STATE_SENDER_DIFFICULTY ] = "SENDER_DIFFICULTY",
+    [ STATE_SENDER_CONFIRM ] = "SENDER_CONFIRM",
+    [ STATE_SENDER_DIRECTIONS ] = "SENDER_DIRECTIONS",
+    [ STATE_SENDER_TRANSMIT ] = "SENDER_TRANSMIT",
+    [ STATE_SENDER_OUTCOME ] = "SENDER_OUTCOME",
+    [ STATE_RECEIVER_PARAMETERS ] = "RECEIVER_PARAMETERS",
+    [ STATE_RECEIVER_DIRECTIONS ] = "RECEIVER_DIRECTIONS",
+    [ STATE_RECEIVER_PROMPT ] = "RECEIVER_PROMPT",
+    [ STATE_RECEIVER_COUNTDOWN ] = "RECEIVER_COUNTDOWN",
+    [ STATE_RECEIVER_DISPLAY ] = "RECEIVER_DISPLAY",
+    [ STATE_RECEIVER_GO ] = "RECEIVER_GO",
+    [ STATE_RECEIVER_REPEAT ] = "RECEIVER_REPEAT",
+    [ STATE_RECEIVER_RESULT ] = "RECEIVER_RESULT",
+    [ STATE_RECEIVER_LEVEL_WON ] = "RECEIVER_LEVEL_WON",
+    [ STATE_RECEIVER_FAILED ] = "RECEIVER_FAILED",
+    [ STATE_RECEIVER_GAME_WON ] = "RECEIVER_GAME_WON",
+    [ STATE_TOURNAMENT_WAIT ] = "TOURNAMENT_WAIT"
+};
+
+static const char navswitches[] = "NESWP";
+
+static int dumps;
+static unsigned long wraps, last;
+
+/**
+ * Adds a byte to a CRC-8 (polynomial 0x07), as frame.c's table does
+ */
+static uint8_t crcAdd ( uint8_t crc, uint8_t byte ) {
+    int bit;
+
+    crc ^= byte;
+
+    for ( bit = 0; bit < 8; bit++ ) {
+        crc = crc & 0x80 ? ( crc << 1 ) ^ 0x07 : crc << 1;
+    }
+    return crc;
+}
+
+/**
+ * Prints the detail of an event as its kind reads
+ */
+static void detailPrint ( uint8_t kind, uint8_t detail ) {
+    if ( ( kind == TRACE_STATE ) && ( detail < STATE_COUNT ) ) {
+        printf ( "%s", states[ detail ] );
+    } else if ( ( kind == TRACE_NAV ) && ( detail < sizeof ( navswitches ) - 1 ) ) {
+        printf ( "%c", navswitches[ detail ] );
+    } else if ( ( detail >= ' ' ) && ( detail < 0x7f ) ) {
+        printf ( "0x%02x '%c'", detail, detail );
+    } else {
+        printf ( "0x%02x", detail );
+    }
+}
+
+/**
+ * Prints the events of a trace frame, starting a new dump at sequence 0
+ */
+static void framePrint ( uint8_t sequence, const uint8_t *payload, uint8_t length ) {
+    unsigned long time;
+    uint8_t i;
+
+    if ( sequence == 0 ) {
+        printf ( "%sdump %d\n", dumps ? "\n" : "", dumps + 1 );
+        dumps++;
+        wraps = 0;
+        last = 0;
+    }
+
+    for ( i = 0; i + TRACE_ENTRY_BYTES <= length; i += TRACE_ENTRY_BYTES ) {
+        time = payload[ i ] | payload[ i + 1 ] << 8;
+
+        if ( time + wraps < last ) {
+            wraps += 0x10000;
+        }
+        last = time + wraps;
+        printf ( "%10.3f  %-6s ", last / 1e3, payload[ i + 2 ] < TRACE_KINDS ? kinds[ payload[ i + 2 ] ] : "?" );
+        detailPrint ( payload[ i + 2 ], payload[ i + 3 ] );
+        printf ( "\n" );
+    }
+}
+
+/**
+ * Finds the trace frames in a stream of infra-red bytes and prints them
+ */
+static void streamDecode ( FILE *file ) {
+    uint8_t header[ FRAME_HEADER_SIZE ], payload[ UINT8_MAX ];
+    uint8_t crc = 0;
+    int byte, index = 0;
+
+    while ( ( byte = getc ( file ) ) != EOF ) {
+        if ( index == 0 ) {
+            index = byte == FRAME_START;
+            header[ 0 ] = byte;
+            crc = 0;
+            continue;
+        } else if ( index < FRAME_HEADER_SIZE ) {
+            header[ index ] = byte;
+        } else if ( index < FRAME_HEADER_SIZE + header[ 3 ] ) {
+            payload[ index - FRAME_HEADER_SIZE ] = byte;
+        } else {
+            if ( ( byte == crc ) && ( header[ 1 ] == FRAME_TRACE ) ) {
+                framePrint ( header[ 2 ], payload, header[ 3 ] );
+            }
+            index = 0;
+            continue;
+        }
+        crc = crcAdd ( crc, byte );
+        index++;
+    }
+}
+
+int main ( int argc, char *argv[] ) {
+    FILE *file;
+    int i;
+
+    if ( argc == 1 ) {
+        streamDecode ( stdin );
+    }
+
+    for ( i = 1; i < argc; i++ ) {
+        if ( !( file = fopen ( argv[ i ], "rb" ) ) ) {
+            perror ( argv[ i ] );
+            return EXIT_FAILURE;
+        }
+        streamDecode ( file );
+        fclose ( file );
+    }
+    return dumps ? EXIT_SUCCESS : EXIT_FAILURE;
+}
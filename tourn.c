@@ -0,0 +1,57 @@
+/**
+* @file     tourn.c
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    C program for an interactive memory game between microcontrollers - tournament schedule
+*
+* A match frame carries the node sending it and the match it starts,
+* which addresses it to that match's pair, as tourn.h explains.
+*/
+
+#include "frame.h"
+#include "tourn.h"
+
+/**
+ * Returns the number of matches in a round of a tournament
+ */
+uint8_t tournamentRound ( uint8_t nodes ) {
+    return nodes * ( nodes - 1 );
+}
+
+/**
+ * Sets the SENDER and RECEIVER nodes of a match of a round. Lap d of
+ * the round pairs each node with the node d + 1 on, so with two boards
+ * the roles simply swap each match.
+ */
+void tournamentPair ( uint8_t nodes, uint8_t match, uint8_t *sender, uint8_t *receiver ) {
+    uint8_t offset = 1 + match / nodes;
+
+    *sender = match % nodes;
+    *receiver = ( *sender + offset ) % nodes;
+}
+
+/**
+ * Sends copies of the frame, from a node to every board, starting a
+ * match, as many as fit whole in the transmission queue. Its sequence
+ * number is the match, below LINK_RELIABLE, so no board acknowledges it.
+ */
+void tournamentSend ( ir_t *ir, uint8_t node, uint8_t match, uint8_t copies ) {
+    uint8_t payload[ TOURNAMENT_PAYLOAD ] = { node, match };
+    uint8_t i;
+
+    for ( i = 0; ( i < copies ) && frameRoom ( ir, TOURNAMENT_PAYLOAD ); i++ ) {
+        frameSend ( ir, FRAME_MATCH, match, payload, TOURNAMENT_PAYLOAD );
+    }
+}
+
+/**
+ * Reads the match a received frame starts, returning false if the frame
+ * does not start one
+ */
+bool tournamentReceive ( const frame_t *frame, uint8_t *match ) {
+    if ( ( frame->type != FRAME_MATCH ) || ( frame->length != TOURNAMENT_PAYLOAD ) ) {
+        return false;
+    }
+    *match = frame->payload[ 1 ];
+    return true;
+}
@@ -0,0 +1,71 @@
+/**
+* @file     tourn.h
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Header file for tourn.c of the interactive memory game between microcontrollers - tournament schedule
+*
+* In a tournament, up to TOURNAMENT_NODES_MAX boards, each with its own
+* node ID from 0, take turns to play a match: one game from SENDER
+* choosing a difficulty until RECEIVER fails a level or wins. Every
+* board works out which pair plays a match from the match number alone,
+* so the only message a tournament adds is the frame starting a match.
+*
+* Frames carry no destination node. The match number addresses a match
+* frame: each board pairs it with tournamentPair () and plays only if it
+* is the SENDER or RECEIVER node. The frame must still reach every board.
+* The new pair starts playing, and the last match's pair and everyone
+* else wait, so a destination byte would always be a broadcast. The
+* pair's game frames need no address either. Every other board is in
+* STATE_TOURNAMENT_WAIT, where its link only listens. It discards
+* every frame but a match frame, and acknowledges none, except copies of
+* the last frame it took in its own match. So only the pair acts on the
+* pair's frames. The channel is quiet but for the pair and the board
+* announcing the match.
+*/
+
+#ifndef TOURN_H
+#define TOURN_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "frame.h"
+
+#define TOURNAMENT_NODES_MAX 8
+#define TOURNAMENT_PAYLOAD 2
+#define TOURNAMENT_REPEATS 3 // copies of a match frame sent to start a match
+#define TOURNAMENT_ANNOUNCE_PERIOD 1000 // ms between copies sent again until the match is heard playing
+#define FRAME_MATCH 'M'
+
+
+/**
+ * Returns the number of matches in a round of a tournament, in which
+ * every board sends once to every other board
+ */
+uint8_t tournamentRound ( uint8_t nodes );
+
+
+/**
+ * Sets the SENDER and RECEIVER nodes of a match of a round. Each lap
+ * of the round has every board send once and receive once, to the
+ * board a fixed number of nodes on, so the roles rotate board to board.
+ */
+void tournamentPair ( uint8_t nodes, uint8_t match, uint8_t *sender, uint8_t *receiver );
+
+
+/**
+ * Sends copies of the frame, from a node to every board, starting a
+ * match, as many as fit whole in the transmission queue. No one board
+ * could acknowledge it for all, so it is sent unacknowledged, and sent
+ * again every TOURNAMENT_ANNOUNCE_PERIOD by the board starting the
+ * match until it hears the match played. Copies after the first are
+ * ignored by boards already in the match.
+ */
+void tournamentSend ( ir_t *ir, uint8_t node, uint8_t match, uint8_t copies );
+
+
+/**
+ * Reads the match a received frame starts, returning false if the frame
+ * does not start one
+ */
+bool tournamentReceive ( const frame_t *frame, uint8_t *match );
+#endif
@@ -0,0 +1,108 @@
+/**
+* @file     trace.c
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    C program for an interactive memory game between microcontrollers - event trace
+*
+* A write stores four bytes and moves the head on, with no allocation
+* and no search. A dump sends the events oldest first, TRACE_PER_FRAME
+* to a frame, with the frames sequence numbered from 0. Each event is
+* its millisecond, low byte first, then its kind and detail. Events are
+* not written while a dump is sent, so the dump's own bytes are not
+* traced over the events it is sending.
+*/
+
+#include "trace.h"
+
+#ifdef TRACE
+
+#include "frame.h"
+
+#define TRACE_MASK ( TRACE_SIZE - 1 )
+
+#ifdef __AVR__
+static trace_t *trace;
+#else
+static _Thread_local trace_t *trace;
+#endif
+
+/**
+ * Empties a trace, stamping its events from a tick clock
+ */
+void traceInit ( trace_t *buffer, const tick_t *clock ) {
+    buffer->clock = clock;
+    buffer->head = 0;
+    buffer->count = 0;
+    buffer->dump = 0;
+}
+
+/**
+ * Selects the trace the calling thread's events are written to
+ */
+void traceSelect ( trace_t *buffer ) {
+    trace = buffer;
+}
+
+/**
+ * Writes an event to the selected trace, over its oldest event if full
+ */
+void traceWrite ( uint8_t kind, uint8_t detail ) {
+    trace_entry_t *entry;
+
+    if ( !trace || trace->dump ) {
+        return;
+    }
+    entry = &trace->entries[ trace->head++ & TRACE_MASK ];
+    entry->time = trace->clock->millis;
+    entry->kind = kind;
+    entry->detail = detail;
+
+    if ( trace->count < TRACE_SIZE ) {
+        trace->count++;
+    }
+}
+
+/**
+ * Starts sending the selected trace's events over infra-red
+ */
+void traceDump ( void ) {
+    if ( !trace->dump ) {
+        trace->dump = trace->count;
+    }
+}
+
+/**
+ * Returns true while a dump of the selected trace is being sent
+ */
+bool traceDumping ( void ) {
+    return trace->dump != 0;
+}
+
+/**
+ * Sends the next frame of a dump of the selected trace if the transmit
+ * ring has room for it
+ */
+void traceDumpUpdate ( ir_t *ir ) {
+    uint8_t payload[ TRACE_PER_FRAME * TRACE_ENTRY_BYTES ];
+    uint8_t events = trace->dump < TRACE_PER_FRAME ? trace->dump : TRACE_PER_FRAME;
+    uint8_t length = events * TRACE_ENTRY_BYTES;
+    uint8_t first = trace->head - trace->dump;
+    const trace_entry_t *entry;
+    uint8_t i;
+
+    if ( !events || !frameRoom ( ir, length ) ) {
+        return;
+    }
+
+    for ( i = 0; i < events; i++ ) {
+        entry = &trace->entries[ ( first + i ) & TRACE_MASK ];
+        payload[ i * TRACE_ENTRY_BYTES ] = entry->time;
+        payload[ i * TRACE_ENTRY_BYTES + 1 ] = entry->time >> 8;
+        payload[ i * TRACE_ENTRY_BYTES + 2 ] = entry->kind;
+        payload[ i * TRACE_ENTRY_BYTES + 3 ] = entry->detail;
+    }
+    frameSend ( ir, FRAME_TRACE, ( trace->count - trace->dump ) / TRACE_PER_FRAME, payload, length );
+    trace->dump -= events;
+}
+
+#endif
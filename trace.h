@@ -0,0 +1,118 @@
+/**
+* @file     trace.h
+* @authors  Adam Ross
+* @date     12 Oct 2016
+* @brief    Header file for trace.c of the interactive memory game between microcontrollers - event trace
+*
+* Build with "make TRACE=1" to record the last TRACE_SIZE game events,
+* each stamped with the tick clock's millisecond, in a ring in SRAM.
+* Without TRACE the hooks compile to nothing. Pushing the board's button
+* sends the ring over infra-red, oldest event first, for tools/tracedec
+* to turn back into a timeline. The host simulation is always built
+* with TRACE.
+*/
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tick.h"
+#include "ir.h"
+
+#define TRACE_SIZE 32 // events, power of two
+#define TRACE_ENTRY_BYTES 4
+#define TRACE_PER_FRAME 4 // events
+#define FRAME_TRACE 'Q'
+
+
+/**
+ * The kinds of event traced, each with one byte of detail
+ */
+enum {
+    TRACE_STATE, // the state moved to
+    TRACE_IR_TX, // a byte queued for transmission
+    TRACE_IR_RX, // a recepted byte read
+    TRACE_NAV, // the navswitch pressed
+    TRACE_LEVEL, // the level moved to
+    TRACE_KINDS
+};
+
+
+/**
+ * One traced event
+ */
+typedef struct {
+    uint16_t time;
+    uint8_t kind;
+    uint8_t detail;
+} trace_entry_t;
+
+
+/**
+ * The last TRACE_SIZE events of one game, the clock they are stamped
+ * from, and the number of events of a dump still to be sent
+ */
+typedef struct {
+    const tick_t *clock;
+    uint8_t head;
+    uint8_t count;
+    uint8_t dump;
+    trace_entry_t entries[ TRACE_SIZE ];
+} trace_t;
+
+
+#ifdef TRACE
+
+#define TRACE_EVENT(kind, detail) traceWrite ( ( kind ), ( detail ) )
+
+
+/**
+ * Empties a trace, stamping its events from a tick clock
+ */
+void traceInit ( trace_t *trace, const tick_t *clock );
+
+
+/**
+ * Selects the trace the calling thread's events are written to
+ */
+void traceSelect ( trace_t *trace );
+
+
+/**
+ * Writes an event to the selected trace, over its oldest event if full.
+ * Nothing is written while a dump is being sent.
+ */
+void traceWrite ( uint8_t kind, uint8_t detail );
+
+
+/**
+ * Starts sending the selected trace's events over infra-red
+ */
+void traceDump ( void );
+
+
+/**
+ * Returns true while a dump of the selected trace is being sent
+ */
+bool traceDumping ( void );
+
+
+/**
+ * Sends the next frame of a dump of the selected trace if the transmit
+ * ring has room for it
+ */
+void traceDumpUpdate ( ir_t *ir );
+
+#else
+
+#define TRACE_EVENT(kind, detail) ( ( void ) 0 )
+
+#define traceInit(trace, clock)
+#define traceSelect(trace)
+#define traceDump()
+#define traceDumpUpdate(ir)
+
+#endif
+
+#endif